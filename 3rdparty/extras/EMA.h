@@ -15,6 +15,7 @@
 #ifndef EMA_H_
 #define EMA_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 
@@ -75,4 +76,21 @@ inline void ema_apply_update(float& runningValue,
   runningValue -= alpha * (runningValue - newValue);
 }
 
+/**
+ * Apply the same EMA update to n independent lanes sharing one alpha:
+ *
+ *   runningValues[i] <- runningValues[i] - alpha * (runningValues[i] - newValues[i])
+ *
+ * Branch-free over contiguous, non-aliasing arrays so that the compiler
+ * emits SIMD code for it (SSE/AVX, NEON, wasm simd128).
+ */
+inline void ema_apply_update(float* __restrict runningValues,
+                             const float* __restrict newValues,
+                             float alpha,
+                             std::size_t n)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    runningValues[i] -= alpha * (runningValues[i] - newValues[i]);
+}
+
 #endif // EMA_H_
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "avalanche_algorithms.hpp"
+
 #include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
@@ -15,7 +17,14 @@ public:
   halp_meta(name, "Avalanches")
   halp_meta(category, "Analysis/Data")
   halp_meta(c_name, "puara_avalanches_avnd")
-  halp_meta(description, "Detects avalanches in a stream of binarized events.")
+  halp_meta(
+      description,
+      "Detects avalanches in a stream of binarized events: runs of events "
+      "separated by at most Time Bin. Outputs the size and duration of the "
+      "avalanches that ended during the tick. By default each array is analysed "
+      "on its own; in Streaming mode the arrays are consecutive chunks of one "
+      "signal and an avalanche spanning several chunks is reported once, as "
+      "soon as no further event can extend it.")
   halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
   halp_meta(uuid, "268579f9-0848-4d31-9937-4904445fcf2e")
 
@@ -23,6 +32,8 @@ public:
   {
     halp::val_port<"Input", std::vector<double>> input_array;
     halp::knob_f32<"Time Bin (s)", halp::range{0.0, 0.05, 0.008}> time_bin;
+    halp::toggle<"Streaming"> streaming{false};
+    halp::impulse_button<"Reset"> reset;
   } inputs;
 
   struct outs
@@ -38,6 +49,7 @@ public:
 
 private:
   double m_sampling_rate{1000.0};
+  algorithms::AvalancheTracker m_tracker;
 };
 
 }
@@ -1,41 +1,46 @@
 #include "Binarizer.hpp"
 
-#include <xtensor/containers/xadapt.hpp>
-#include <xtensor/containers/xarray.hpp>
-#include <xtensor/core/xfunction.hpp>
-#include <xtensor/core/xmath.hpp>
-
 namespace puara_gestures::objects
 {
 
-void Binarizer::operator()()
+template <typename T>
+void Binarizer::binarize(const std::vector<T>& in_vec)
 {
-  const auto& in_vec = inputs.input_array.value;
-  if(in_vec.empty())
-  {
-    outputs.output_array.value.clear();
-    return;
-  }
-  const float thresh = inputs.threshold;
-  const auto thresh_type = inputs.threshold_type.value;
+  const auto format = inputs.output_format.value;
+  const auto type = inputs.threshold_type.value;
+  const T thresh = inputs.threshold;
 
-  std::vector<size_t> shape = {in_vec.size()};
-  auto in_arr = xt::adapt(in_vec.data(), in_vec.size(), xt::no_ownership(), shape);
+  // Written in place: the outputs keep their capacity from one tick to the
+  // next, and only the selected one is filled
+  auto& doubles = outputs.output_array.value;
+  auto& bytes = outputs.output_bytes.value;
+  auto& bits = outputs.output_bits.value;
+  doubles.resize(format == OutputFormat::Doubles ? in_vec.size() : 0);
+  bytes.resize(format == OutputFormat::Bytes ? in_vec.size() : 0);
+  bits.resize(format == OutputFormat::Bits ? (in_vec.size() + 63) / 64 : 0);
 
-  xt::xarray<double> binarized_arr;
-  switch(thresh_type)
+  switch(format)
   {
-    case ThresholdType::Above:
-      binarized_arr = xt::where(in_arr > thresh, 1.0, 0.0);
+    case OutputFormat::Doubles:
+      algorithms::with_threshold(type, thresh, [&](auto crosses) {
+        for(std::size_t i = 0; i < in_vec.size(); ++i)
+          doubles[i] = crosses(in_vec[i]) ? 1.0 : 0.0;
+      });
       break;
-    case ThresholdType::Below:
-      binarized_arr = xt::where(in_arr < thresh, 1.0, 0.0);
+    case OutputFormat::Bytes:
+      algorithms::threshold_bytes(in_vec.data(), in_vec.size(), type, thresh, bytes.data());
       break;
-    case ThresholdType::Both:
-    default:
-      binarized_arr = xt::where(xt::abs(in_arr) > thresh, 1.0, 0.0);
+    case OutputFormat::Bits:
+      algorithms::threshold_bits(in_vec.data(), in_vec.size(), type, thresh, bits.data());
       break;
   }
-  outputs.output_array.value.assign(binarized_arr.begin(), binarized_arr.end());
+}
+
+void Binarizer::operator()()
+{
+  if(!inputs.input_float.value.empty())
+    binarize(inputs.input_float.value);
+  else
+    binarize(inputs.input_array.value);
 }
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "threshold_algorithms.hpp"
+
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 
+#include <cstdint>
 #include <vector>
 
 namespace puara_gestures::objects
@@ -14,15 +17,23 @@ public:
   halp_meta(name, "Binarize")
   halp_meta(category, "Analysis/Puara")
   halp_meta(c_name, "puara_binarize_avnd")
-  halp_meta(description, "Binarizes an input array based on a threshold.")
+  halp_meta(
+      description,
+      "Binarizes an input array based on a threshold. The array is read from "
+      "Input (float) when that one is not empty, from Input otherwise. Output "
+      "Format picks the output filled on each tick: one double or one byte per "
+      "sample, or Packed Bits where bit i % 64 of word i / 64 is sample i (with "
+      "64 interleaved channels, one word per frame).")
   halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
   halp_meta(uuid, "84931c47-894b-45bb-addc-3163ae3593da")
 
-  enum class ThresholdType
+  using ThresholdType = algorithms::ThresholdType;
+
+  enum class OutputFormat
   {
-    Both,
-    Above,
-    Below
+    Doubles,
+    Bytes,
+    Bits
   };
   struct
   {
@@ -30,15 +41,23 @@ public:
     halp::val_port<"Input", std::vector<double>> input_array;
     halp::knob_f32<"Threshold", halp::range{0.0, 5.0, 2.0}> threshold;
     halp::enum_t<ThresholdType, "Threshold Type"> threshold_type{ThresholdType::Both};
+    halp::val_port<"Input (float)", std::vector<float>> input_float;
+    halp::enum_t<OutputFormat, "Output Format"> output_format{OutputFormat::Doubles};
 
   } inputs;
 
   struct
   {
     halp::val_port<"Binarized Output", std::vector<double>> output_array;
+    halp::val_port<"Bytes", std::vector<std::uint8_t>> output_bytes;
+    halp::val_port<"Packed Bits", std::vector<std::uint64_t>> output_bits;
   } outputs;
 
   void operator()();
+
+private:
+  template <typename T>
+  void binarize(const std::vector<T>& in_vec);
 };
 
 }
@@ -1,224 +1,149 @@
 #include "ClusteringAvnd.hpp"
 
 #include <algorithm>
-#include <limits>
-#include <numeric>
-#include <random>
 
 namespace puara_gestures::objects
 {
-
-struct KMeansResult
+namespace
+{
+template <typename Model>
+void copy_model(
+    const Model& model, std::vector<double>& labels, std::vector<double>& centers)
 {
-  std::vector<unsigned long> assignments;
-  std::vector<std::vector<double>> centers;
-};
+  const auto& c = model.centers();
+  centers.assign(c.data(), c.data() + c.size());
+  labels.assign(model.labels().begin(), model.labels().end());
+}
+}
 
-KMeansResult custom_kmeans(
-    const std::vector<std::vector<double>>& samples, int k, int max_iterations = 100)
+void ClusteringAvnd::fit(
+    const std::vector<double>& input_vec, int n_features, int k, Algorithm algorithm,
+    unsigned seed, bool warm_start, Workspace& ws, FitResult& result,
+    std::stop_token stop)
 {
-  if(samples.empty() || k <= 0 || k > (int)samples.size())
+  result.labels.clear();
+  result.centers.clear();
+
+  if(input_vec.empty() || n_features <= 0 || k <= 0
+     || (input_vec.size() % n_features != 0))
+  {
+    return;
+  }
+  const int n_samples = input_vec.size() / n_features;
+  if(n_samples < k)
   {
-    return {{}, {}};
+    return;
   }
-  const int n_samples = samples.size();
-  const int n_dims = samples[0].size();
-  std::vector<std::vector<double>> centers(k);
-  std::vector<int> indices(n_samples);
-  std::iota(indices.begin(), indices.end(), 0);
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::shuffle(indices.begin(), indices.end(), gen);
-  for(int i = 0; i < k; ++i)
+
+  if(algorithm == Algorithm::KMeans)
   {
-    centers[i] = samples[indices[i]];
+    if(ws.kmeans.fit(
+           input_vec.data(), n_samples, n_features, k, seed, warm_start, stop))
+      copy_model(ws.kmeans, result.labels, result.centers);
   }
-  std::vector<unsigned long> assignments(n_samples);
-  for(int iter = 0; iter < max_iterations; ++iter)
+  else if(algorithm == Algorithm::Agglomerative)
   {
-    bool changed = false;
-    for(int i = 0; i < n_samples; ++i)
-    {
-      double best_dist = std::numeric_limits<double>::max();
-      unsigned long best_center = 0;
-      for(int j = 0; j < k; ++j)
-      {
-        double dist = 0.0;
-        for(int d = 0; d < n_dims; ++d)
-        {
-          double diff = samples[i][d] - centers[j][d];
-          dist += diff * diff;
-        }
-        if(dist < best_dist)
-        {
-          best_dist = dist;
-          best_center = j;
-        }
-      }
-      if(assignments[i] != best_center)
-      {
-        assignments[i] = best_center;
-        changed = true;
-      }
-    }
-    if(!changed)
-      break;
-    std::vector<std::vector<double>> new_centers(k, std::vector<double>(n_dims, 0.0));
-    std::vector<int> counts(k, 0);
-    for(int i = 0; i < n_samples; ++i)
-    {
-      int cluster_idx = assignments[i];
-      for(int d = 0; d < n_dims; ++d)
-      {
-        new_centers[cluster_idx][d] += samples[i][d];
-      }
-      counts[cluster_idx]++;
-    }
-    for(int j = 0; j < k; ++j)
-    {
-      if(counts[j] > 0)
-      {
-        for(int d = 0; d < n_dims; ++d)
-        {
-          new_centers[j][d] /= counts[j];
-        }
-        centers[j] = new_centers[j];
-      }
-    }
+    if(ws.linkage.fit(input_vec.data(), n_samples, n_features, k, stop))
+      copy_model(ws.linkage, result.labels, result.centers);
   }
-  return {assignments, centers};
 }
 
-/**
- * @brief A custom implementation of single-linkage agglomerative clustering.
- * This function starts with each point in its own cluster and iteratively
- * merges the two closest clusters until only k clusters remain.
- *
- * @author Yash Tiwari
- */
-std::vector<unsigned long>
-custom_agglomerative_cluster(const std::vector<std::vector<double>>& samples, int k)
+void ClusteringAvnd::prepare(halp::setup)
 {
-  const int n_samples = samples.size();
-  if(k <= 0 || k > n_samples)
-    return {};
+  if(m_fitter)
+    return;
 
-  std::vector<std::vector<int>> clusters(n_samples);
-  for(int i = 0; i < n_samples; ++i)
-  {
-    clusters[i] = {i};
-  }
+  // The worker owns its own clustering buffers
+  m_fitter = std::make_unique<Fitter>(
+      [ws = Workspace{}](
+          const FitJob& job, FitResult& result, std::stop_token stop) mutable {
+    if(job.reset)
+      ws.kmeans.reset();
+    fit(job.matrix, job.n_features, job.n_clusters, job.algorithm, job.seed,
+        job.warm_start, ws, result, stop);
+    result.generation = job.generation;
+  });
+}
 
-  while(clusters.size() > (size_t)k)
-  {
-    double min_dist = std::numeric_limits<double>::max();
-    std::pair<int, int> closest_pair = {-1, -1};
-
-    for(size_t i = 0; i < clusters.size(); ++i)
-    {
-      for(size_t j = i + 1; j < clusters.size(); ++j)
-      {
-        for(int sample_idx_i : clusters[i])
-        {
-          for(int sample_idx_j : clusters[j])
-          {
-            double dist = 0.0;
-            for(size_t d = 0; d < samples[0].size(); ++d)
-            {
-              double diff = samples[sample_idx_i][d] - samples[sample_idx_j][d];
-              dist += diff * diff;
-            }
-            if(dist < min_dist)
-            {
-              min_dist = dist;
-              closest_pair = {(int)i, (int)j};
-            }
-          }
-        }
-      }
-    }
-
-    if(closest_pair.first != -1)
-    {
-      int idx1 = closest_pair.first;
-      int idx2 = closest_pair.second;
-      clusters[idx1].insert(
-          clusters[idx1].end(), clusters[idx2].begin(), clusters[idx2].end());
-      clusters.erase(clusters.begin() + idx2);
-    }
-    else
-    {
-      break;
-    }
-  }
-  std::vector<unsigned long> assignments(n_samples);
-  for(size_t i = 0; i < clusters.size(); ++i)
+void ClusteringAvnd::run_background()
+{
+  // Publish the last finished clustering, then hand the current data to the worker
+  if(m_fitter->poll(m_fit_result) && m_fit_result.generation == m_generation)
   {
-    for(int sample_idx : clusters[i])
-    {
-      assignments[sample_idx] = i;
-    }
+    std::swap(m_result.labels, m_fit_result.labels);
+    std::swap(m_result.centers, m_fit_result.centers);
   }
-  return assignments;
-}
 
-std::vector<std::vector<double>>
-vector_to_samples(const std::vector<double>& vec, int num_cols)
-{
-  std::vector<std::vector<double>> samples;
-  if(num_cols == 0 || vec.empty())
-    return samples;
-  int num_rows = vec.size() / num_cols;
-  samples.reserve(num_rows);
-  for(int r = 0; r < num_rows; ++r)
+  if(m_fitter->idle())
   {
-    samples.emplace_back(vec.begin() + r * num_cols, vec.begin() + (r + 1) * num_cols);
+    auto& job = m_fitter->job();
+    job.matrix.assign(inputs.matrix.value.begin(), inputs.matrix.value.end());
+    job.n_features = inputs.n_features.value;
+    job.n_clusters = inputs.n_clusters.value;
+    job.algorithm = inputs.algorithm.value;
+    job.seed = unsigned(inputs.seed.value);
+    job.warm_start = inputs.warm_start.value;
+    job.reset = m_reset_pending;
+    job.generation = m_generation;
+    m_reset_pending = false;
+    m_fitter->submit();
   }
-  return samples;
+
+  outputs.cluster_labels.value = m_result.labels;
+  outputs.cluster_centers.value = m_result.centers;
 }
 
-void ClusteringAvnd::operator()()
+void ClusteringAvnd::run_online()
 {
   const auto& input_vec = inputs.matrix.value;
   const int n_features = inputs.n_features.value;
-  const int k = inputs.n_clusters.value;
 
-  if(input_vec.empty() || n_features <= 0 || k <= 0
-     || (input_vec.size() % n_features != 0))
+  if(input_vec.empty() || n_features <= 0 || (input_vec.size() % n_features != 0)
+     || !m_online.partial_fit(
+         input_vec.data(), int(input_vec.size() / n_features), n_features,
+         inputs.n_clusters.value, unsigned(inputs.seed.value)))
   {
     outputs.cluster_labels.value.clear();
     outputs.cluster_centers.value.clear();
     return;
   }
-  const int n_samples = input_vec.size() / n_features;
-  if(n_samples < k)
+
+  copy_model(m_online, outputs.cluster_labels.value, outputs.cluster_centers.value);
+}
+
+void ClusteringAvnd::operator()()
+{
+  if(inputs.reset.value.has_value())
   {
-    outputs.cluster_labels.value.clear();
-    outputs.cluster_centers.value.clear();
-    return;
+    m_online.reset();
+    m_workspace.kmeans.reset();
+    // The background worker forgets its warm-start centers with its next job
+    m_reset_pending = true;
+    ++m_generation;
   }
 
-  std::vector<unsigned long> assignments;
-  auto samples = vector_to_samples(input_vec, n_features);
-
-  if(inputs.algorithm.value == Algorithm::KMeans)
+  // Online updates are proportional to the incoming rows: always on the tick
+  if(inputs.algorithm.value == Algorithm::OnlineKMeans)
   {
-    auto result = custom_kmeans(samples, k);
-    assignments = result.assignments;
-    std::vector<double> center_vec;
-    for(const auto& center : result.centers)
-    {
-      center_vec.insert(center_vec.end(), center.begin(), center.end());
-    }
-    outputs.cluster_centers.value = std::move(center_vec);
+    run_online();
+    return;
   }
-  else
+
+  // The worker is started by prepare(): without it, fit on the tick
+  if(inputs.background.value && m_fitter)
   {
-    assignments = custom_agglomerative_cluster(samples, k);
-    outputs.cluster_centers.value.clear();
+    run_background();
+    return;
   }
 
-  std::vector<double> labels_vec(assignments.begin(), assignments.end());
-  outputs.cluster_labels.value = std::move(labels_vec);
+  fit(inputs.matrix.value, inputs.n_features.value, inputs.n_clusters.value,
+      inputs.algorithm.value, unsigned(inputs.seed.value), inputs.warm_start.value,
+      m_workspace, m_result);
+  ++m_generation;
+
+  // Copied rather than swapped: m_result stays the latest clustering, which
+  // is what Background Fit outputs until its first fit is ready
+  outputs.cluster_labels.value = m_result.labels;
+  outputs.cluster_centers.value = m_result.centers;
 }
 }
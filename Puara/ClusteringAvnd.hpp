@@ -1,8 +1,13 @@
 #pragma once
 
+#include "async_fit.hpp"
+#include "clustering_algorithms.hpp"
+
+#include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace puara_gestures::objects
@@ -14,13 +19,25 @@ public:
   halp_meta(name, "Clustering")
   halp_meta(category, "AI/Data processing")
   halp_meta(c_name, "puara_clustering_avnd")
-  halp_meta(description, "Performs KMeans or Agglomerative clustering on input data.")
+  halp_meta(
+      description,
+      "Performs KMeans or Agglomerative (single-linkage) clustering on input data, "
+      "and outputs the labels and the mean of every cluster. "
+      "KMeans is seeded with k-means++ from Seed, so identical data gives identical "
+      "clusters. Warm Start begins from the previous centers when the number of "
+      "clusters and features is unchanged, keeping labels stable on streams. "
+      "OnlineKMeans clusters an unbounded stream: each tick's rows update the "
+      "centers (mini-batch k-means) and only the incoming rows are labelled; its "
+      "centers are seeded with k-means++ from Seed over the first tick. "
+      "With Background Fit, clustering runs on a worker thread and the previous "
+      "labels and centers are output until the new ones are ready.")
   halp_meta(uuid, "8fa7709c-4232-47b8-82be-4889ae08656d")
 
   enum class Algorithm
   {
     KMeans,
-    Agglomerative
+    Agglomerative,
+    OnlineKMeans
   };
 
   struct ins
@@ -29,15 +46,69 @@ public:
     halp::enum_t<Algorithm, "Algorithm"> algorithm{Algorithm::KMeans};
     halp::knob_i32<"Num Clusters", halp::range{1, 20, 2}> n_clusters;
     halp::knob_i32<"Num Features", halp::range{1, 128, 1}> n_features;
+    halp::spinbox_i32<"Seed", halp::range{0, 1000000, 0}> seed;
+    halp::toggle<"Warm Start", halp::toggle_setup{false}> warm_start;
+    halp::toggle<"Background Fit", halp::toggle_setup{false}> background;
+    halp::impulse_button<"Reset"> reset;
   } inputs;
 
   struct outs
   {
     halp::val_port<"Cluster Labels", std::vector<double>> cluster_labels;
-    halp::val_port<"Cluster Centers", std::vector<double>>
-        cluster_centers; // For KMeans only
+    halp::val_port<"Cluster Centers", std::vector<double>> cluster_centers;
   } outputs;
 
+  // Starts the background fit worker
+  void prepare(halp::setup info);
   void operator()();
+
+private:
+  struct FitJob
+  {
+    std::vector<double> matrix;
+    int n_features{0};
+    int n_clusters{0};
+    Algorithm algorithm{Algorithm::KMeans};
+    unsigned seed{0};
+    bool warm_start{false};
+    bool reset{false};
+    unsigned generation{0};
+  };
+
+  // Buffers reused from one fit to the next
+  struct Workspace
+  {
+    algorithms::KMeans kmeans;
+    algorithms::SingleLinkage linkage;
+  };
+
+  struct FitResult
+  {
+    std::vector<double> labels;
+    std::vector<double> centers;
+    unsigned generation{0};
+  };
+
+  // Clusters the row-major `matrix`; empty labels and centers if it cannot,
+  // or if `stop` was requested
+  static void fit(
+      const std::vector<double>& matrix, int n_features, int n_clusters,
+      Algorithm algorithm, unsigned seed, bool warm_start, Workspace& ws,
+      FitResult& result, std::stop_token stop = {});
+
+  void run_background();
+  void run_online();
+
+  Workspace m_workspace;
+  algorithms::OnlineKMeans m_online;
+  bool m_reset_pending{false};
+  FitResult m_result;
+
+  // Background fits carry the generation they were started in; one that
+  // finishes after a reset or a newer synchronous fit is dropped
+  using Fitter = algorithms::AsyncFit<FitJob, FitResult>;
+  std::unique_ptr<Fitter> m_fitter;
+  FitResult m_fit_result;
+  unsigned m_generation{0};
 };
 }
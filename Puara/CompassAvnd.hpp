@@ -1,5 +1,7 @@
 #pragma once
 
+#include "angle_algorithms.hpp"
+
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 
@@ -14,14 +16,21 @@ public:
   halp_meta(name, "Compass")
   halp_meta(category, "Analysis/Puara")
   halp_meta(c_name, "puara_compass_avnd")
-  halp_meta(description, "Calculates angles from two N-dimensional polar arrays.")
+  halp_meta(
+      description,
+      "Calculates angles from two N-dimensional polar arrays. Accuracy trades "
+      "precision for speed on long arrays: Exact uses atan2, Fast stays within "
+      "1e-6 degree of it and Fastest within 1e-3 degree.")
   halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
   halp_meta(uuid, "b0a377c7-0c7c-4525-be9a-2c3d0e67d41c")
 
+  using Accuracy = algorithms::AtanAccuracy;
+
   struct ins
   {
     halp::val_port<"Pole 1", std::vector<double>> pole1;
     halp::val_port<"Pole 2", std::vector<double>> pole2;
+    halp::enum_t<Accuracy, "Accuracy"> accuracy{Accuracy::Exact};
   } inputs;
 
   struct outs
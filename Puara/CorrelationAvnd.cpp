@@ -1,8 +1,6 @@
 #include "CorrelationAvnd.hpp"
 
-#include "statistics_algorithms.hpp"
-
-#include <xtensor/containers/xadapt.hpp>
+#include <algorithm>
 
 namespace puara_gestures::objects
 {
@@ -12,6 +10,26 @@ void CorrelationAvnd::operator()()
   const auto& vec1 = inputs.data1.value;
   const auto& vec2 = inputs.data2.value;
 
+  if(inputs.mode.value == Mode::Streaming)
+  {
+    // Restart the window when it is resized, on mode switch or on reset
+    const bool window_changed = m_window_watcher.changed(inputs.window.value);
+    const bool mode_changed = m_mode_watcher.changed(inputs.mode.value);
+    if(window_changed || mode_changed)
+      m_sliding.resize(std::max(inputs.window.value, 3));
+    else if(inputs.reset.value.has_value())
+      m_sliding.reset();
+
+    // Pairs beyond the shorter chunk have no counterpart and are dropped
+    m_sliding.push(vec1.data(), vec2.data(), std::min(vec1.size(), vec2.size()));
+
+    auto [r, p] = m_sliding.result();
+    outputs.pearson.value = r;
+    outputs.p_value.value = p;
+    return;
+  }
+  m_mode_watcher.changed(inputs.mode.value);
+
   if(vec1.empty() || vec2.empty() || vec1.size() != vec2.size())
   {
     outputs.pearson.value = 0.0;
@@ -19,9 +37,7 @@ void CorrelationAvnd::operator()()
     return;
   }
 
-  auto arr1 = xt::adapt(vec1);
-  auto arr2 = xt::adapt(vec2);
-  auto [r, p] = algorithms::calculate_pearson(arr1, arr2);
+  auto [r, p] = algorithms::calculate_pearson(vec1.data(), vec2.data(), vec1.size());
 
   outputs.pearson.value = r;
   outputs.p_value.value = p;
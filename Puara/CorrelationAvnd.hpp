@@ -1,4 +1,7 @@
 #pragma once
+#include "halp_utils.hpp"
+#include "statistics_algorithms.hpp"
+
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 #include <vector>
@@ -14,14 +17,25 @@ public:
   halp_meta(c_name, "puara_correlation_avnd")
   halp_meta(
       description,
-      "Computes the Pearson correlation and p-value between two data arrays.")
+      "Computes the Pearson correlation and p-value between two data arrays. "
+      "In Streaming mode the arrays are new samples appended to a sliding window, "
+      "and the correlation is updated in O(new samples) per tick.")
   halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
   halp_meta(uuid, "202a5150-0452-403f-930e-7fa18564c863")
 
+  enum class Mode
+  {
+    Window,   ///< Each tick's arrays are the whole window
+    Streaming ///< Each tick's arrays are new samples for a sliding window
+  };
+
   struct ins
   {
     halp::val_port<"Data 1", std::vector<double>> data1;
     halp::val_port<"Data 2", std::vector<double>> data2;
+    halp::enum_t<Mode, "Mode"> mode{Mode::Window};
+    halp::spinbox_i32<"Window size", halp::range{3, 1000000, 256}> window;
+    halp::impulse_button<"Reset"> reset;
   } inputs;
 
   struct outs
@@ -31,6 +45,11 @@ public:
   } outputs;
 
   void operator()();
+
+private:
+  algorithms::SlidingPearson m_sliding;
+  halp::ParameterWatcher<int> m_window_watcher;
+  halp::ParameterWatcher<Mode> m_mode_watcher;
 };
 
 }
@@ -1,79 +1,192 @@
 #include "ERPAvnd.hpp"
 
-#include <xtensor/containers/xadapt.hpp>
-#include <xtensor/core/xmath.hpp>
-#include <xtensor/views/xview.hpp>
+#include <algorithm>
 
 namespace puara_gestures::objects
 {
 
+void ERPAvnd::prepare(halp::setup& setup)
+{
+  m_sampling_rate = setup.rate;
+  m_chunk_frames = std::max<std::size_t>(m_chunk_frames, std::max(1, setup.frames));
+  resize_epoch(
+      static_cast<std::size_t>(inputs.duration.value * m_sampling_rate),
+      std::max(1, inputs.channels.value));
+}
+
 void ERPAvnd::operator()()
 {
-  if(!inputs.reset.value.has_value())
+  if(inputs.reset.value.has_value())
   {
     reset_state();
   }
 
+  const auto target_frames
+      = static_cast<std::size_t>(inputs.duration.value * m_sampling_rate);
+  const auto channels = static_cast<std::size_t>(std::max(1, inputs.channels.value));
+  if(target_frames != m_epoch_frames || channels != m_channels)
+  {
+    resize_epoch(target_frames, channels);
+  }
+
   const auto& signal_chunk = inputs.signal.value;
-  if(signal_chunk.empty())
+  if(signal_chunk.empty() || m_epoch_frames == 0 || signal_chunk.size() % m_channels != 0)
   {
     return;
   }
-  const bool triggered = inputs.trigger.value.has_value();
-  if(triggered)
+
+  // An epoch starts with the chunk received along with its trigger
+  if(inputs.trigger.value.has_value())
   {
-    if(!m_is_collecting || !inputs.delay_retrigger.value)
+    if(inputs.overlap.value || m_pending == 0)
+    {
+      // At most one epoch can start per tick and each tick brings at least one
+      // frame, so the m_epoch_frames slots never run out
+      if(m_pending < m_starts.size())
+      {
+        m_starts[(m_first_start + m_pending) % m_starts.size()] = m_written;
+        ++m_pending;
+      }
+    }
+    else if(!inputs.delay_retrigger.value)
     {
-      m_is_collecting = true;
-      m_collected_chunk.clear();
+      m_starts[m_first_start] = m_written;
     }
   }
-  if(!m_is_collecting)
+  if(m_pending == 0)
   {
     return;
   }
-  m_collected_chunk.insert(
-      m_collected_chunk.end(), signal_chunk.begin(), signal_chunk.end());
 
-  const int target_samples = static_cast<int>(inputs.duration.value * m_sampling_rate);
-  if(m_collected_chunk.size() < target_samples)
+  // Only the frames that an in-flight epoch can still need are stored
+  const std::size_t frames = signal_chunk.size() / m_channels;
+  reserve_history(m_epoch_frames + frames);
+  const std::size_t row = m_written % m_history_frames;
+  const std::size_t head = std::min(frames, m_history_frames - row);
+  std::copy_n(
+      signal_chunk.begin(), head * m_channels, m_history.begin() + row * m_channels);
+  std::copy(
+      signal_chunk.begin() + head * m_channels, signal_chunk.end(), m_history.begin());
+  m_written += frames;
+
+  bool completed = false;
+  while(m_pending > 0 && m_starts[m_first_start] + m_epoch_frames <= m_written)
+  {
+    accumulate(m_starts[m_first_start]);
+    m_first_start = (m_first_start + 1) % m_starts.size();
+    --m_pending;
+    completed = true;
+  }
+  if(!completed)
   {
     return;
   }
-  auto collected_arr = xt::adapt(m_collected_chunk);
-  auto erp_segment = xt::view(collected_arr, xt::range(0, target_samples));
 
+  const double inv_count = 1.0 / m_erp_count;
+  auto& erp = outputs.erp.value;
+  erp.resize(m_erp_sum.size());
+  for(std::size_t i = 0; i < m_erp_sum.size(); ++i)
+  {
+    erp[i] = m_erp_sum[i] * inv_count;
+  }
+}
+
+void ERPAvnd::accumulate(std::uint64_t start)
+{
+  // The epoch is at most two contiguous runs of rows in the history:
+  // (rows, first epoch frame, frame count)
+  const std::size_t row = start % m_history_frames;
+  const std::size_t head = std::min(m_epoch_frames, m_history_frames - row);
+  const struct
+  {
+    const double* rows;
+    std::size_t offset;
+    std::size_t count;
+  } runs[2]{
+      {m_history.data() + row * m_channels, 0, head},
+      {m_history.data(), head, m_epoch_frames - head}};
+
+  std::fill(m_baseline.begin(), m_baseline.end(), 0.0);
   if(inputs.baseline.value == BaselineCorrection::Mean)
   {
-    erp_segment = erp_segment - xt::mean(erp_segment)();
+    for(const auto& run : runs)
+    {
+      if(m_channels == 1)
+      {
+        double b = 0.0;
+        for(std::size_t t = 0; t < run.count; ++t)
+          b += run.rows[t];
+        m_baseline[0] += b;
+        continue;
+      }
+      for(std::size_t t = 0; t < run.count; ++t)
+        for(std::size_t c = 0; c < m_channels; ++c)
+          m_baseline[c] += run.rows[t * m_channels + c];
+    }
+    for(double& b : m_baseline)
+      b /= double(m_epoch_frames);
   }
 
-  if(m_erp_count == 0)
+  for(const auto& run : runs)
   {
-    m_erp_sum = erp_segment;
+    double* sum = m_erp_sum.data() + run.offset * m_channels;
+    if(m_channels == 1)
+    {
+      const double b = m_baseline[0];
+      for(std::size_t t = 0; t < run.count; ++t)
+        sum[t] += run.rows[t] - b;
+      continue;
+    }
+    for(std::size_t t = 0; t < run.count; ++t)
+      for(std::size_t c = 0; c < m_channels; ++c)
+        sum[t * m_channels + c] += run.rows[t * m_channels + c] - m_baseline[c];
   }
-  else if(m_erp_sum.size() != erp_segment.size())
+  m_erp_count++;
+}
+
+void ERPAvnd::reserve_history(std::size_t frames)
+{
+  if(frames <= m_history_frames)
   {
-    reset_state();
-    m_erp_sum = erp_segment;
+    return;
   }
-  else
+
+  // Only grows when a longer chunk than expected arrives: re-place the frames
+  // still needed by the in-flight epochs at their new rows
+  m_chunk_frames = frames - m_epoch_frames;
+  std::vector<double> history(frames * m_channels);
+  const std::uint64_t kept = std::min<std::uint64_t>(m_written, m_history_frames);
+  for(std::uint64_t f = m_written - kept; f < m_written; ++f)
   {
-    m_erp_sum += erp_segment;
+    std::copy_n(
+        m_history.begin() + (f % m_history_frames) * m_channels, m_channels,
+        history.begin() + (f % frames) * m_channels);
   }
-  m_erp_count++;
-  xt::xarray<double> final_erp = m_erp_sum / m_erp_count;
-  outputs.erp.value.assign(final_erp.begin(), final_erp.end());
-  m_is_collecting = false;
-  m_collected_chunk.clear();
+  m_history.swap(history);
+  m_history_frames = frames;
+}
+
+void ERPAvnd::resize_epoch(std::size_t frames, std::size_t channels)
+{
+  m_epoch_frames = frames;
+  m_channels = channels;
+  // The history keeps its storage when the new shape fits in it
+  m_history_frames = frames + m_chunk_frames;
+  m_history.resize(m_history_frames * channels);
+  m_starts.resize(frames);
+  m_baseline.resize(channels);
+  m_erp_sum.resize(frames * channels);
+  outputs.erp.value.reserve(frames * channels);
+  reset_state();
 }
 
 void ERPAvnd::reset_state()
 {
   m_erp_count = 0;
-  m_is_collecting = false;
-  m_collected_chunk.clear();
-  m_erp_sum.resize({0});
+  m_written = 0;
+  m_first_start = 0;
+  m_pending = 0;
+  std::fill(m_erp_sum.begin(), m_erp_sum.end(), 0.0);
   outputs.erp.value.clear();
 }
 
@@ -3,8 +3,8 @@
 #include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
-#include <xtensor/containers/xarray.hpp>
 
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -19,7 +19,11 @@ public:
   halp_meta(c_name, "puara_erp_avnd")
   halp_meta(
       description,
-      "Computes an Event-Related Potential (ERP) from a signal and triggers.")
+      "Computes an Event-Related Potential (ERP) from a signal and triggers. "
+      "With several channels, the signal and the ERP are interleaved "
+      "(frame by frame). With Overlapping Epochs, every trigger starts an epoch "
+      "even while earlier ones are still being collected; otherwise Delay "
+      "Retrigger chooses between ignoring such triggers and restarting the epoch.")
   halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
   halp_meta(uuid, "4f9c3a03-48df-4c30-ba0e-653989b37843")
 
@@ -39,6 +43,8 @@ public:
     halp::enum_t<BaselineCorrection, "Baseline"> baseline{BaselineCorrection::Mean};
     halp::impulse_button<"Reset"> reset;
     halp::toggle<"Delay Retrigger"> delay_retrigger{true};
+    halp::knob_i32<"Channels", halp::range{1, 64, 1}> channels;
+    halp::toggle<"Overlapping Epochs"> overlap{false};
   } inputs;
 
   struct outs
@@ -46,18 +52,46 @@ public:
     halp::val_port<"ERP", std::vector<double>> erp;
   } outputs;
 
-  void prepare(halp::setup& setup) { m_sampling_rate = setup.rate; }
+  void prepare(halp::setup& setup);
   void operator()();
 
 private:
   void reset_state();
 
+  // Sizes the buffers, history included, for epochs of `frames` x `channels`
+  // and chunks of up to m_chunk_frames; only allocates when they grow
+  void resize_epoch(std::size_t frames, std::size_t channels);
+
+  // Makes room for `frames` in the history, keeping the in-flight epochs.
+  // Only allocates for a chunk longer than any expected so far.
+  void reserve_history(std::size_t frames);
+
+  // Adds the epoch starting at absolute frame `start` to the running sum
+  void accumulate(std::uint64_t start);
+
   // --- State Variables ---
   double m_sampling_rate{1000.0};
-  bool m_is_collecting{false};
   int m_erp_count{0};
-  std::vector<double> m_collected_chunk;
-  xt::xarray<double> m_erp_sum;
+  std::size_t m_epoch_frames{0};
+  std::size_t m_channels{1};
+  // Longest chunk the history is sized for: the host's block size, or the
+  // longest chunk received since
+  std::size_t m_chunk_frames{1};
+
+  // Circular history of the last m_history_frames interleaved frames, shared
+  // by every in-flight epoch; frame f is stored at row f % m_history_frames
+  std::vector<double> m_history;
+  std::size_t m_history_frames{0};
+  std::uint64_t m_written{0};
+
+  // Start frames of the in-flight epochs, oldest first (a FIFO over a ring:
+  // epochs complete in the order they were triggered)
+  std::vector<std::uint64_t> m_starts;
+  std::size_t m_first_start{0};
+  std::size_t m_pending{0};
+
+  std::vector<double> m_baseline;
+  std::vector<double> m_erp_sum;
 };
 
 }
@@ -31,6 +31,14 @@ public:
     halp::val_port<"GSR_signal", float> GSR_signal;
 
     halp::knob_f32<"GSR threshold", halp::range{0., 1., 0.}> GSR_threshold;
+
+    // Disabled descriptors are not updated and hold their last outputs
+    halp::toggle<"Enable Jab", halp::toggle_setup{.init = true}> enable_jab;
+    halp::toggle<"Enable Shake", halp::toggle_setup{.init = true}> enable_shake;
+    halp::toggle<"Enable Tilt", halp::toggle_setup{.init = true}> enable_tilt;
+    halp::toggle<"Enable Roll", halp::toggle_setup{.init = true}> enable_roll;
+    halp::toggle<"Enable Heart", halp::toggle_setup{.init = true}> enable_heart;
+    halp::toggle<"Enable GSR", halp::toggle_setup{.init = true}> enable_gsr;
   } inputs;
 
   struct
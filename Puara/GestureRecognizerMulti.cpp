@@ -0,0 +1,110 @@
+#include "GestureRecognizerMulti.hpp"
+
+#include <algorithm>
+
+namespace puara_gestures::objects
+{
+void GestureRecognizerMulti::resize(std::size_t users)
+{
+  m_jab.resize(users);
+  m_shake.resize(users);
+  m_tilt.resize(users);
+  m_roll.resize(users);
+  m_heart.resize(users);
+  m_gsr.resize(users);
+
+  // Outputs only allocate when the number of users grows
+  outputs.jab.value.resize(users);
+  outputs.shake.value.resize(users);
+  outputs.heart_raw.value.resize(users);
+  outputs.heart_normalized.value.resize(users);
+  outputs.heart_beat.value.resize(users);
+  outputs.heart_bpm.value.resize(users);
+  outputs.heart_bpmChange.value.resize(users);
+  outputs.heart_amplitudeChange.value.resize(users);
+  outputs.GSR_raw.value.resize(users);
+  outputs.GSR_SCR.value.resize(users);
+  outputs.GSR_SCL.value.resize(users);
+}
+
+void GestureRecognizerMulti::operator()(halp::tick t)
+{
+  const double period = t.frames / setup.rate;
+  const auto& accel = inputs.accel.value;
+  const std::size_t users = accel.size();
+  if(users != m_jab.size())
+  {
+    resize(users);
+  }
+
+  if(inputs.enable_jab)
+  {
+    for(std::size_t i = 0; i < users; ++i)
+    {
+      const auto& [ax, ay, az] = accel[i];
+      m_jab[i].update(ax, ay, az);
+      outputs.jab.value[i] = m_jab[i].current_value();
+    }
+  }
+  if(inputs.enable_shake)
+  {
+    for(std::size_t i = 0; i < users; ++i)
+    {
+      const auto& [ax, ay, az] = accel[i];
+      m_shake[i].update(ax, ay, az);
+      outputs.shake.value[i] = m_shake[i].current_value();
+    }
+  }
+
+  const auto& gyro = inputs.gyro.value;
+  const auto& mag = inputs.mag.value;
+  const bool has_orientation = gyro.size() == users && mag.size() == users;
+  if(inputs.enable_tilt)
+  {
+    auto& tilt = outputs.tilt.value;
+    tilt.resize(has_orientation ? users : 0);
+    for(std::size_t i = 0; i < tilt.size(); ++i)
+      tilt[i] = m_tilt[i].tilt(accel[i], gyro[i], mag[i], period);
+  }
+  if(inputs.enable_roll)
+  {
+    auto& roll = outputs.roll.value;
+    roll.resize(has_orientation ? users : 0);
+    for(std::size_t i = 0; i < roll.size(); ++i)
+      roll[i] = m_roll[i].roll(accel[i], gyro[i], mag[i], period);
+  }
+
+  if(inputs.enable_heart)
+  {
+    const auto& heart_signal = inputs.heart_signal.value;
+    const std::size_t heart_users = std::min(users, heart_signal.size());
+    for(std::size_t i = 0; i < heart_users; ++i)
+      m_heart[i].update(heart_signal[i]);
+    for(std::size_t i = 0; i < users; ++i)
+    {
+      auto& heart = m_heart[i];
+      outputs.heart_raw.value[i] = heart.getRaw();
+      outputs.heart_normalized.value[i] = heart.getNormalized();
+      outputs.heart_beat.value[i] = heart.beatDetected();
+      outputs.heart_bpm.value[i] = heart.getBPM();
+      outputs.heart_bpmChange.value[i] = heart.bpmChange();
+      outputs.heart_amplitudeChange.value[i] = heart.amplitudeChange();
+    }
+  }
+
+  if(inputs.enable_gsr)
+  {
+    const auto& gsr_signal = inputs.GSR_signal.value;
+    const std::size_t gsr_users = std::min(users, gsr_signal.size());
+    for(std::size_t i = 0; i < gsr_users; ++i)
+      m_gsr[i].update(gsr_signal[i]);
+    for(std::size_t i = 0; i < users; ++i)
+    {
+      auto& gsr = m_gsr[i];
+      outputs.GSR_raw.value[i] = gsr.getRaw();
+      outputs.GSR_SCR.value[i] = gsr.getSCR();
+      outputs.GSR_SCL.value[i] = gsr.getSCL();
+    }
+  }
+}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "3rdparty/BioData/src/Heart.h"
+#include "3rdparty/BioData/src/SkinConductance.h"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+#include <puara/gestures.h>
+
+#include <vector>
+
+namespace puara_gestures::objects
+{
+// Gesture recognizer for N users at once: element i of every input and output
+// array belongs to user i. The per-user state is kept in one array per
+// descriptor and each descriptor runs over all users in turn, so adding a user
+// costs its descriptor updates and nothing else.
+class GestureRecognizerMulti
+{
+public:
+  halp_meta(name, "Gesture recognizer (multi-user)")
+  halp_meta(category, "Analysis/Gestures")
+  halp_meta(c_name, "puara_gestures_multi")
+  halp_meta(
+      description,
+      "Gesture recognizer for several users in one node. The number of users is "
+      "the size of the Acceleration array; element i of every array belongs to "
+      "user i. Tilt and Roll need Gyroscope and Magnetometer arrays of the same "
+      "size; users without a Heart or GSR sample keep their previous values.")
+  halp_meta(
+      author,
+      "Puara authors, Edu Meneses, Rochana Fardon, Sarah Al Mamoun, Joseph Malloch, "
+      "Maggie Needham")
+  halp_meta(manual_url, "https://ossia.io/score-docs/processes/gestures.html")
+  halp_meta(uuid, "b5b8c9c1-de7f-4dee-93a9-f2d763e5c753")
+
+  struct
+  {
+    halp::val_port<"Acceleration", std::vector<puara_gestures::Coord3D>> accel;
+    halp::val_port<"Gyroscope", std::vector<puara_gestures::Coord3D>> gyro;
+    halp::val_port<"Magnetometer", std::vector<puara_gestures::Coord3D>> mag;
+    halp::val_port<"Heart_signal", std::vector<float>> heart_signal;
+    halp::val_port<"GSR_signal", std::vector<float>> GSR_signal;
+
+    // Disabled descriptors are not updated and hold their last outputs
+    halp::toggle<"Enable Jab", halp::toggle_setup{.init = true}> enable_jab;
+    halp::toggle<"Enable Shake", halp::toggle_setup{.init = true}> enable_shake;
+    halp::toggle<"Enable Tilt", halp::toggle_setup{.init = true}> enable_tilt;
+    halp::toggle<"Enable Roll", halp::toggle_setup{.init = true}> enable_roll;
+    halp::toggle<"Enable Heart", halp::toggle_setup{.init = true}> enable_heart;
+    halp::toggle<"Enable GSR", halp::toggle_setup{.init = true}> enable_gsr;
+  } inputs;
+
+  struct
+  {
+    halp::val_port<"Jab", std::vector<puara_gestures::Coord3D>> jab;
+    halp::val_port<"Shake", std::vector<puara_gestures::Coord3D>> shake;
+    halp::val_port<"Tilt", std::vector<float>> tilt;
+    halp::val_port<"Roll", std::vector<float>> roll;
+    halp::val_port<"Heart_raw", std::vector<float>> heart_raw;
+    halp::val_port<"Heart_normalized", std::vector<float>> heart_normalized;
+    halp::val_port<"Heart_beatDetected", std::vector<int>> heart_beat;
+    halp::val_port<"Heart_bpm", std::vector<float>> heart_bpm;
+    halp::val_port<"Heart_bpmChange", std::vector<float>> heart_bpmChange;
+    halp::val_port<"Heart_amplitudeChange", std::vector<float>> heart_amplitudeChange;
+    halp::val_port<"GSR_raw", std::vector<float>> GSR_raw;
+    halp::val_port<"GSR_SCR", std::vector<float>> GSR_SCR;
+    halp::val_port<"GSR_SCL", std::vector<float>> GSR_SCL;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info) { setup = info; }
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+private:
+  // Adds or removes users; existing users keep their state
+  void resize(std::size_t users);
+
+  std::vector<puara_gestures::Jab3D> m_jab;
+  std::vector<puara_gestures::Shake3D> m_shake;
+  std::vector<puara_gestures::Tilt> m_tilt;
+  std::vector<puara_gestures::Roll> m_roll;
+  std::vector<Heart> m_heart;
+  std::vector<SkinConductance> m_gsr;
+};
+
+}
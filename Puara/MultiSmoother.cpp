@@ -0,0 +1,103 @@
+#include "MultiSmoother.hpp"
+
+#include "Smoother.hpp"
+#include "3rdparty/extras/EMA.h"
+
+#include <algorithm>
+
+namespace puara_gestures::objects
+{
+void MultiSmoother::prepare(halp::setup info)
+{
+  setup = info;
+
+  filtered.clear();
+  sample_count = 0;
+  last_modified = Parameter::Alpha;
+
+  // First tick always computes the coefficients
+  cumulative_watcher = {};
+  alpha_watcher = {};
+  tau_watcher = {};
+  cutoff_watcher = {};
+  dt_watcher = {};
+}
+
+void MultiSmoother::update_coefficients(float dt)
+{
+  switch(last_modified)
+  {
+    case Parameter::Alpha:
+      alpha_eff = std::clamp(static_cast<float>(inputs.alpha), 0.0f, 1.0f);
+      break;
+    case Parameter::Tau:
+      alpha_eff = Smoother::time_window_to_alpha(inputs.tau, dt);
+      break;
+    case Parameter::Cutoff:
+      alpha_eff = Smoother::cutoff_to_alpha(inputs.cutoff, dt);
+      break;
+  }
+}
+
+void MultiSmoother::operator()(halp::tick t)
+{
+  // Calculate time step
+  float dt = DEFAULT_DT;
+  if(setup.rate > 0.0)
+  {
+    const float maybe_dt = static_cast<float>(t.frames) / static_cast<float>(setup.rate);
+    if(maybe_dt > 0.0f && maybe_dt < 0.1f)
+      dt = maybe_dt;
+  }
+
+  // Detect parameter changes. The first watcher call after prepare() reports a
+  // change, which does not count as a user edit for the alpha/tau/cutoff choice.
+  const bool first = alpha_watcher.first;
+  const bool cumulative_changed = cumulative_watcher.changed(inputs.cumulative);
+  const bool alpha_changed = alpha_watcher.changed(inputs.alpha);
+  const bool tau_changed = tau_watcher.changed(inputs.tau);
+  const bool cutoff_changed = cutoff_watcher.changed(inputs.cutoff);
+  const bool dt_changed = dt_watcher.changed(dt);
+
+  if(!first)
+  {
+    if(alpha_changed)
+      last_modified = Parameter::Alpha;
+    if(tau_changed)
+      last_modified = Parameter::Tau;
+    if(cutoff_changed)
+      last_modified = Parameter::Cutoff;
+  }
+
+  if(cumulative_changed)
+    sample_count = 0;
+
+  if(alpha_changed || tau_changed || cutoff_changed || dt_changed)
+    update_coefficients(dt);
+
+  const auto& in = inputs.signals.value;
+  const std::size_t n = in.size();
+
+  // New channel layout: restart from the current input
+  if(filtered.size() != n)
+  {
+    filtered.assign(in.begin(), in.end());
+    sample_count = 0;
+  }
+
+  if(inputs.cumulative)
+  {
+    // Cumulative mode: α = 1/(n+1), the first sample passes through
+    const float alpha = ema_alpha(true, -1.0, sample_count, dt);
+    ema_apply_update(filtered.data(), in.data(), alpha, n);
+    sample_count++;
+  }
+  else
+  {
+    ema_apply_update(filtered.data(), in.data(), alpha_eff, n);
+    sample_count = 0;
+  }
+
+  outputs.out.value.assign(filtered.begin(), filtered.end());
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "halp_utils.hpp"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace puara_gestures::objects
+{
+// N-lane exponential moving average sharing one set of coefficients
+class MultiSmoother
+{
+public:
+  halp_meta(name, "Smoother (multichannel)")
+  halp_meta(category, "Analysis/Data")
+  halp_meta(c_name, "MultiSmoother")
+  halp_meta(
+      description,
+      "Smooth every element of an array with the same exponential moving average "
+      "filter, e.g. all the channels of a sensor glove in one node. "
+      "Alpha: direct smoothing coefficient (0=frozen, 1=no smoothing). "
+      "Tau: time constant in seconds. "
+      "Cutoff: equivalent low-pass frequency in Hz. "
+      "Cumulative: infinite-window averaging (α = 1/(n+1)). "
+      "The last modified parameter is the one in use. "
+      "Changing the number of channels restarts the filter.")
+  halp_meta(author, "Luana Belinsky")
+  halp_meta(manual_url, "https://ossia.io/score-docs/")
+  halp_meta(uuid, "a753b77f-833b-4d86-a206-a79d05ec9e94")
+
+  struct
+  {
+    halp::data_port<
+        "Signals", "Input signals to smooth, one element per channel.",
+        std::vector<float>>
+        signals;
+
+    halp::toggle<"Cumulative average", halp::toggle_setup{false}> cumulative;
+    halp::hslider_f32<"Alpha coefficient", halp::range{0.0, 1.0, 0.5}> alpha;
+    halp::spinbox_f32<"Time window tau (s)", halp::range{0.0, 1000.0, 1.0}> tau;
+    halp::spinbox_f32<"Cutoff frequency (Hz)", halp::range{0.0, 2000.0, 2.0}> cutoff;
+  } inputs;
+
+  struct
+  {
+    halp::data_port<
+        "Smoothed", "Smoothed output signals, same size as the input.",
+        std::vector<float>>
+        out;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info);
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+private:
+  // recompute alpha_eff from the last modified parameter
+  void update_coefficients(float dt);
+
+  // Per-lane filter state
+  std::vector<float> filtered;
+
+  // Sample counter for cumulative mode (shared by all lanes)
+  uint32_t sample_count{0};
+
+  // Current effective alpha for filtering
+  float alpha_eff{0.5f};
+
+  // Parameter watchers: coefficients are only recomputed when one of them
+  // reports a change or when dt changes
+  halp::ParameterWatcher<bool> cumulative_watcher;
+  halp::ParameterWatcher<float> alpha_watcher;
+  halp::ParameterWatcher<float> tau_watcher;
+  halp::ParameterWatcher<float> cutoff_watcher;
+  halp::ParameterWatcher<float> dt_watcher;
+
+  enum class Parameter
+  {
+    Alpha,
+    Tau,
+    Cutoff
+  };
+  Parameter last_modified{Parameter::Alpha};
+
+  // Default time step (0.01s = 100Hz)
+  static constexpr float DEFAULT_DT = 0.01f;
+};
+}
@@ -0,0 +1,82 @@
+#include "NormalizationAudio.hpp"
+
+#include <cmath>
+
+namespace puara_gestures::objects
+{
+void NormalizationAudio::prepare(halp::setup info)
+{
+  setup = info;
+
+  norm = Normalizer(Normalizer::kDefaultTargetMean, Normalizer::kDefaultTargetStdDev);
+
+  // Force every parameter to be applied on the first block
+  mean_watch = {};
+  std_watch = {};
+  time_watch = {};
+  clamp_watch = {};
+  clamp_enable_watch = {};
+  infinite_watch = {};
+  update_parameters();
+}
+
+void NormalizationAudio::update_parameters()
+{
+  const bool mean_changed = mean_watch.changed(inputs.target_mean);
+  const bool std_changed = std_watch.changed(inputs.target_std);
+  const bool time_changed = time_watch.changed(inputs.time_window);
+  const bool clamp_changed = clamp_watch.changed(inputs.clamp_nsig);
+  const bool clamp_en_changed = clamp_enable_watch.changed(inputs.clamp_enable);
+  const bool inf_changed = infinite_watch.changed(inputs.infinite_time_window);
+
+  if(mean_changed)
+    norm.targetMean(inputs.target_mean);
+
+  if(std_changed)
+    norm.targetStdDev(inputs.target_std);
+
+  if(time_changed || inf_changed)
+    norm.timeWindow(inputs.infinite_time_window ? 0.0f : inputs.time_window);
+
+  if(clamp_en_changed || clamp_changed)
+  {
+    if(inputs.clamp_enable)
+      norm.clamp(inputs.clamp_nsig);
+    else
+      norm.noClamp();
+  }
+}
+
+void NormalizationAudio::operator()(halp::tick t)
+{
+  const double* in = inputs.audio.channel;
+  double* out = outputs.audio.channel;
+  if(!in || !out || t.frames <= 0)
+    return;
+
+  update_parameters();
+
+  // One sample per put(): dt is the sample period
+  const double dt = setup.rate > 0.0 ? 1.0 / setup.rate : 0.0;
+  const float thresh = inputs.out_thresh;
+
+  bool outlier = false;
+  for(int i = 0; i < t.frames; ++i)
+  {
+    const float x = static_cast<float>(in[i]);
+    out[i] = norm.put(x, dt);
+
+    // Plaquette-style: raw value is ≥ N stddev away from running mean
+    outlier |= norm.isOutlier(x, thresh);
+  }
+
+  const float mu = norm.mean();
+  const float sd = norm.stddev();
+  outputs.mean = mu;
+  outputs.stddev = sd;
+  outputs.outlier = outlier;
+
+  // Classic coefficient of variation (positive signals only)
+  outputs.variation = (sd > 0.0f && std::fabs(mu) >= 1e-6f) ? sd / mu : 0.0f;
+}
+} // namespace puara_gestures::objects
@@ -0,0 +1,98 @@
+#pragma once
+#include "3rdparty/extras/Normalizer.h"
+#include "halp_utils.hpp"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+namespace puara_gestures::objects
+{
+// audio-rate version of Normalization: one put() per sample, parameters once per block
+class NormalizationAudio
+{
+public:
+  halp_meta(name, "Normalizer (audio)")
+  halp_meta(category, "Analysis/Data")
+  halp_meta(c_name, "NormalizerAudio")
+  halp_meta(author, "Luana Belinsky (adapted from Sofian Audry’s Plaquette)")
+  halp_meta(
+      description,
+      "Adaptive normalizer running at audio rate, with a time window (seconds). "
+      "Tracks running mean and standard deviation of the input and "
+      "maps every sample to a target mean & standard deviation.\n"
+      "Statistics outputs are updated once per block.\n"
+      "Note: Coefficient of variation (CV) is computed as stddev / mean and "
+      "assumes a strictly positive signal.")
+  halp_meta(manual_url, "https://plaquette.org/Normalizer.html")
+  halp_meta(uuid, "6ab93a47-7d71-4a02-8877-f3ffb2e57f5e")
+
+  struct
+  {
+    halp::audio_channel<"Signal", double> audio;
+
+    halp::knob_f32<"Target mean", halp::range{0.0, 1.0, 0.5}> target_mean;
+
+    halp::knob_f32<"Target std dev", halp::range{0.0, 10.0, 0.15}> target_std;
+
+    halp::knob_f32<"Time window (s)", halp::range{0.01, 360.0, 1.0}> time_window;
+
+    halp::toggle<"Infinite time window"> infinite_time_window{false};
+
+    halp::knob_f32<"Outlier threshold", halp::range{0.0, 10.0, 1.5}> out_thresh;
+
+    halp::toggle<"Clamp output"> clamp_enable{true};
+
+    halp::knob_f32<"Clamp max", halp::range{0.10, 5.00, 3.33}> clamp_nsig;
+  } inputs;
+
+  struct
+  {
+    halp::audio_channel<"Normalized signal", double> audio;
+
+    halp::data_port<
+        "Mean", "Float. Running mean of the input signal at the end of the block.",
+        float>
+        mean;
+
+    halp::data_port<
+        "Standard deviation",
+        "Float. Standard deviation of the input signal at the end of the block.", float>
+        stddev;
+
+    halp::data_port<
+        "Outlier",
+        "Boolean. True when at least one sample of the block is N standard deviations "
+        "or more away from the running mean.",
+        bool>
+        outlier;
+
+    halp::data_port<
+        "Coefficient of variation",
+        "Float. Ratio of standard deviation to mean.\n"
+        "Only valid for strictly positive signals.",
+        float>
+        variation;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info);
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+private:
+  // Apply parameter changes, once per block
+  void update_parameters();
+
+  Normalizer norm{Normalizer::kDefaultTargetMean, Normalizer::kDefaultTargetStdDev};
+
+  // Parameter watchers
+  halp::ParameterWatcher<float> mean_watch;
+  halp::ParameterWatcher<float> std_watch;
+  halp::ParameterWatcher<float> time_watch;
+  halp::ParameterWatcher<float> clamp_watch;
+  halp::ParameterWatcher<bool> clamp_enable_watch;
+  halp::ParameterWatcher<bool> infinite_watch;
+};
+} // namespace puara_gestures::objects
@@ -0,0 +1,32 @@
+#include "Orientation.hpp"
+
+namespace puara_gestures::objects
+{
+void Orientation::operator()(halp::tick t)
+{
+  if(setup.rate <= 0.0 || t.frames <= 0)
+  {
+    return;
+  }
+
+  // Same filter updates as puara_gestures::Tilt::tilt and Roll::roll
+  const double period_s = static_cast<double>(t.frames) / setup.rate;
+  const auto& [ax, ay, az] = inputs.accel.value;
+  const auto& [gx, gy, gz] = inputs.gyro.value;
+  const auto& [mx, my, mz] = inputs.mag.value;
+
+  impl.setAccelerometerValues(ax, ay, az);
+  impl.setGyroscopeRadianValues(gx, gy, gz, period_s);
+  impl.setMagnetometerValues(mx, my, mz);
+  impl.update();
+
+  const auto& q = impl.quaternion;
+  const auto& euler = impl.euler;
+  outputs.orientation.value
+      = {q.w, q.x, q.y, q.z, euler.tilt, euler.roll, euler.azimuth};
+  outputs.quaternion.value = {q.w, q.x, q.y, q.z};
+  outputs.tilt.value = euler.tilt;
+  outputs.roll.value = euler.roll;
+  outputs.yaw.value = euler.azimuth;
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <IMU_Sensor_Fusion/imu_orientation.h>
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+#include <puara/gestures.h>
+
+namespace puara_gestures::objects
+{
+struct Quaternion
+{
+  double w{1.0};
+  double x{0.0};
+  double y{0.0};
+  double z{0.0};
+};
+
+// What the IMU_Sensor_Fusion filter computed for one sensor: its quaternion
+// and its own Euler angles, in radians (yaw is the filter's azimuth)
+struct FusedOrientation
+{
+  double w{1.0};
+  double x{0.0};
+  double y{0.0};
+  double z{0.0};
+  double tilt{0.0};
+  double roll{0.0};
+  double yaw{0.0};
+};
+
+// Runs the IMU sensor fusion once for every node that needs the orientation
+// of the same sensor: Tilt and Roll can read their angle from its
+// Orientation output instead of fusing the raw data themselves.
+class Orientation
+{
+public:
+  halp_meta(name, "Orientation")
+  halp_meta(category, "Analysis/Gestures")
+  halp_meta(c_name, "puara_orientation")
+  halp_meta(
+      description,
+      "Fuses accelerometer, gyroscope, and magnetometer data into an orientation "
+      "quaternion, and its tilt, roll, and yaw angles.")
+  halp_meta(manual_url, "https://github.com/Puara/puara-gestures/")
+  halp_meta(uuid, "2c7208ff-acdb-4fe8-8ed1-4f773ff51ec5")
+
+  struct
+  {
+    halp::val_port<"Acceleration", puara_gestures::Coord3D> accel;
+    halp::val_port<"Gyroscope", puara_gestures::Coord3D> gyro;
+    halp::val_port<"Magnetometer", puara_gestures::Coord3D> mag;
+  } inputs;
+
+  struct
+  {
+    halp::val_port<"Orientation", FusedOrientation> orientation;
+    halp::val_port<"Quaternion", Quaternion> quaternion;
+    halp::val_port<"Tilt", float> tilt;
+    halp::val_port<"Roll", float> roll;
+    halp::val_port<"Yaw", float> yaw;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info) { setup = info; }
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+  IMU_Orientation impl;
+};
+
+}
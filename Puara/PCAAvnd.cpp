@@ -4,70 +4,279 @@
 
 namespace puara_gestures::objects
 {
+namespace
+{
+using RowMajorMatrix
+    = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+}
 
-void PCAAvnd::operator()()
+bool PCAAvnd::fit(
+    const std::vector<double>& input_vec, int n_features, int n_components,
+    Solver solver, Workspace& ws, std::vector<double>& components,
+    std::stop_token stop)
 {
-  if(!inputs.reset.value.has_value())
+  if(input_vec.empty() || n_features <= 0 || (input_vec.size() % n_features != 0))
   {
-    m_is_computed = false;
-    m_principal_components.clear();
+    return false;
   }
-  if(m_is_computed)
+  const int n_samples = input_vec.size() / n_features;
+  if(n_samples < n_features)
   {
-    outputs.principal_components.value = m_principal_components;
-    return;
+    return false;
+  }
+
+  // Mapping the input data to matrix (no copy, just viewing) and centering it
+  // straight into the workspace
+  Eigen::Map<const RowMajorMatrix> data_view(input_vec.data(), n_samples, n_features);
+  ws.centered_data = data_view.rowwise() - data_view.colwise().mean();
+  ws.covariance.noalias()
+      = (ws.centered_data.transpose() * ws.centered_data) / (n_samples - 1.0);
+  if(stop.stop_requested())
+  {
+    return false;
+  }
+
+  return solve_covariance(ws.covariance, n_components, solver, ws, components);
+}
+
+bool PCAAvnd::solve_covariance(
+    const Eigen::MatrixXd& covariance, int n_components, Solver solver,
+    Workspace& ws, std::vector<double>& components)
+{
+  if(solver == Solver::TopK && n_components <= covariance.rows())
+  {
+    // Unconverged estimates are still used: the next solve refines them
+    if(ws.top_solver.compute(covariance, n_components))
+    {
+      const auto& vectors = ws.top_solver.eigenvectors();
+      components.assign(vectors.data(), vectors.data() + vectors.size());
+      return true;
+    }
+  }
+
+  ws.eigen_solver.compute(covariance);
+  if(ws.eigen_solver.info() != Eigen::Success)
+  {
+    return false;
+  }
+
+  const auto& eigenvectors = ws.eigen_solver.eigenvectors();
+  if(eigenvectors.cols() < n_components)
+  {
+    return false; // Not enough components found
   }
-  outputs.principal_components.value.clear();
 
+  // Extracting components and reversing (reuse the components matrix)
+  ws.components = eigenvectors.rightCols(n_components).rowwise().reverse();
+  components.assign(ws.components.data(), ws.components.data() + ws.components.size());
+  return true;
+}
+
+void PCAAvnd::update_statistics(const std::vector<double>& input_vec, int n_features)
+{
+  const int n_rows = input_vec.size() / n_features;
+  if(m_mean.size() != n_features)
+  {
+    // New feature count: start over
+    m_mean = Eigen::VectorXd::Zero(n_features);
+    m_scatter = Eigen::MatrixXd::Zero(n_features, n_features);
+    m_count = 0.0;
+  }
+
+  Eigen::Map<const RowMajorMatrix> rows(input_vec.data(), n_rows, n_features);
+  m_batch_mean = rows.colwise().mean().transpose();
+  m_workspace.centered_data = rows.rowwise() - m_batch_mean.transpose();
+
+  // Merge the batch (count, mean, scatter) into the running ones
+  const double n_a = m_count;
+  const double n_b = n_rows;
+  const double n = n_a + n_b;
+  m_batch_mean -= m_mean; // now the difference of the means
+  m_scatter.noalias() += m_workspace.centered_data.transpose() * m_workspace.centered_data;
+  m_scatter.noalias() += (n_a * n_b / n) * (m_batch_mean * m_batch_mean.transpose());
+  m_mean += (n_b / n) * m_batch_mean;
+  m_count = n;
+}
+
+void PCAAvnd::reset_statistics()
+{
+  m_mean.resize(0);
+  m_scatter.resize(0, 0);
+  m_count = 0.0;
+  m_ticks_since_solve = 0;
+  m_solve_queued = false;
+  m_principal_components.clear();
+  ++m_generation;
+}
+
+void PCAAvnd::project(const Eigen::VectorXd& mean)
+{
   const auto& input_vec = inputs.data.value;
   const int n_features = inputs.n_features.value;
-  const int n_components = inputs.n_components.value;
-  if(input_vec.empty() || n_features <= 0 || (input_vec.size() % n_features != 0))
+  auto& out = outputs.projection.value;
+
+  const int n_components
+      = n_features > 0 ? int(m_principal_components.size()) / n_features : 0;
+  if(n_components == 0 || mean.size() != n_features || input_vec.empty()
+     || input_vec.size() % n_features != 0
+     || m_principal_components.size() != std::size_t(n_features) * n_components)
   {
+    out.clear();
     return;
   }
-  const int n_samples = input_vec.size() / n_features;
-  if(n_samples < n_features)
-  {
+
+  const int n_rows = input_vec.size() / n_features;
+  out.resize(std::size_t(n_rows) * n_components);
+
+  Eigen::Map<const RowMajorMatrix> rows(input_vec.data(), n_rows, n_features);
+  Eigen::Map<const Eigen::MatrixXd> components(
+      m_principal_components.data(), n_features, n_components);
+  Eigen::Map<RowMajorMatrix> projection(out.data(), n_rows, n_components);
+  // (x - mean) C = x C - mean C, without a centered copy of the rows
+  m_mean_projection.noalias() = mean.transpose() * components;
+  projection.noalias() = rows * components;
+  projection.rowwise() -= m_mean_projection;
+}
+
+void PCAAvnd::prepare(halp::setup)
+{
+  if(m_fitter)
     return;
+
+  // The worker owns its own workspace
+  m_fitter = std::make_unique<Fitter>(
+      [ws = Workspace{}](
+          const FitJob& job, FitResult& result, std::stop_token stop) mutable {
+    result.valid = job.streaming
+                       ? solve_covariance(
+                             job.covariance, job.n_components, job.solver, ws,
+                             result.components)
+                       : fit(job.data, job.n_features, job.n_components, job.solver, ws,
+                             result.components, stop);
+    result.generation = job.generation;
+  });
+}
+
+void PCAAvnd::run_background(bool streaming)
+{
+  // Publish the last finished fit, then hand the current data to the worker
+  if(m_fitter->poll(m_fit_result) && m_fit_result.valid
+     && m_fit_result.generation == m_generation)
+  {
+    std::swap(m_principal_components, m_fit_result.components);
+  }
+
+  if(m_fitter->idle() && (!streaming || m_solve_queued))
+  {
+    auto& job = m_fitter->job();
+    job.streaming = streaming;
+    if(streaming)
+      job.covariance = m_scatter / (m_count - 1.0);
+    else
+      job.data.assign(inputs.data.value.begin(), inputs.data.value.end());
+    job.n_features = inputs.n_features.value;
+    job.n_components = inputs.n_components.value;
+    job.solver = inputs.solver.value;
+    job.generation = m_generation;
+    m_fitter->submit();
+    m_solve_queued = false;
   }
-  // Resizing matrices only if dimensions changed (avoiding unnecessary allocations)-- change
-  if(m_cached_n_samples != n_samples || m_cached_n_features != n_features)
+}
+
+void PCAAvnd::run_streaming()
+{
+  const auto& input_vec = inputs.data.value;
+  const int n_features = inputs.n_features.value;
+
+  if(inputs.reset.value.has_value() || m_mean.size() != n_features)
   {
-    m_data_matrix.resize(n_samples, n_features);
-    m_centered_data.resize(n_samples, n_features);
-    m_covariance.resize(n_features, n_features);
-    m_components.resize(n_features, n_components);
-    m_cached_n_samples = n_samples;
-    m_cached_n_features = n_features;
+    reset_statistics();
   }
 
-  // Mapping the  input data to matrix (no copy, just viewing)
-  Eigen::Map<
-      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-      data_view(input_vec.data(), n_samples, n_features);
-  m_data_matrix = data_view;
-  m_centered_data = m_data_matrix.rowwise() - m_data_matrix.colwise().mean();
-  m_covariance.noalias()
-      = (m_centered_data.transpose() * m_centered_data) / (n_samples - 1.0);
-  m_eigen_solver.compute(m_covariance);
-  if(m_eigen_solver.info() != Eigen::Success)
+  if(!input_vec.empty() && n_features > 0 && input_vec.size() % n_features == 0)
   {
-    return;
+    update_statistics(input_vec, n_features);
+    ++m_ticks_since_solve;
   }
 
-  const auto& eigenvectors = m_eigen_solver.eigenvectors();
-  if(eigenvectors.cols() < n_components)
+  // Only solve at the requested cadence, once the covariance is defined
+  if(m_count >= 2.0 && m_ticks_since_solve >= inputs.solve_every.value)
+  {
+    m_ticks_since_solve = 0;
+    if(inputs.background.value && m_fitter)
+    {
+      m_solve_queued = true;
+    }
+    else
+    {
+      ++m_generation;
+      m_workspace.covariance = m_scatter / (m_count - 1.0);
+      solve_covariance(
+          m_workspace.covariance, inputs.n_components.value, inputs.solver.value,
+          m_workspace, m_principal_components);
+    }
+  }
+
+  // Keep polling after Background Fit is turned off to collect the last solve
+  if(m_fitter)
   {
-    return; // Not enough components found
+    run_background(true);
   }
 
-  // Extracting components and reversing (reuse m_components matrix)
-  m_components = eigenvectors.rightCols(n_components).rowwise().reverse();
-  m_principal_components.assign(
-      m_components.data(), m_components.data() + m_components.size());
-  m_is_computed = true;
   outputs.principal_components.value = m_principal_components;
+  project(m_mean);
+}
+
+void PCAAvnd::run_batch()
+{
+  // Every tick's rows are decomposed: Reset only drops the components
+  // found so far (and a background fit of older rows still running)
+  if(inputs.reset.value.has_value())
+  {
+    m_principal_components.clear();
+    ++m_generation;
+  }
+
+  // The worker is started by prepare(): without it, fit on the tick
+  if(inputs.background.value && m_fitter)
+  {
+    run_background(false);
+  }
+  else
+  {
+    ++m_generation;
+    if(!fit(
+           inputs.data.value, inputs.n_features.value, inputs.n_components.value,
+           inputs.solver.value, m_workspace, m_principal_components))
+    {
+      m_principal_components.clear();
+      outputs.principal_components.value.clear();
+      outputs.projection.value.clear();
+      return;
+    }
+  }
+  outputs.principal_components.value = m_principal_components;
+
+  // Each batch is projected around its own mean
+  const auto& input_vec = inputs.data.value;
+  const int n_features = inputs.n_features.value;
+  if(input_vec.empty() || n_features <= 0 || input_vec.size() % n_features != 0)
+  {
+    outputs.projection.value.clear();
+    return;
+  }
+  Eigen::Map<const RowMajorMatrix> rows(
+      input_vec.data(), input_vec.size() / n_features, n_features);
+  m_batch_mean = rows.colwise().mean().transpose();
+  project(m_batch_mean);
+}
+
+void PCAAvnd::operator()()
+{
+  if(inputs.mode.value == Mode::Streaming)
+    run_streaming();
+  else
+    run_batch();
 }
 
 }
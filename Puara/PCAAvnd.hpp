@@ -1,8 +1,13 @@
 #pragma once
 
+#include "async_fit.hpp"
+#include "pca_algorithms.hpp"
+
+#include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 
+#include <memory>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -16,35 +21,128 @@ public:
   halp_meta(name, "PCA")
   halp_meta(category, "AI/Data processing")
   halp_meta(c_name, "puara_pca_avnd")
-  halp_meta(description, "Performs Principal Component Analysis on a dataset.")
+  halp_meta(
+      description,
+      "Performs Principal Component Analysis on a dataset. "
+      "Batch: the components of the rows received on each tick. "
+      "Streaming: mean and covariance accumulate over every row received since "
+      "the last reset, and the components are re-solved every Solve Every ticks. "
+      "Projection outputs each incoming row, centered, in component space. "
+      "The Top-K solver only computes the requested components by subspace "
+      "iteration, warm-started from the previous ones: much faster for wide "
+      "feature vectors, but components with nearly equal variances are only "
+      "refined over successive solves. Full decomposes the whole covariance. "
+      "With Background Fit, the decomposition runs on a worker thread and the "
+      "previous components are output until the new ones are ready.")
   halp_meta(uuid, "0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d")
 
+  enum class Mode
+  {
+    Batch,
+    Streaming
+  };
+
+  enum class Solver
+  {
+    Full,
+    TopK
+  };
+
   struct ins
   {
     halp::val_port<"Data", std::vector<double>> data;
     halp::knob_i32<"Num Features", halp::range{1, 128, 2}> n_features;
     halp::knob_i32<"Num Components", halp::range{1, 10, 2}> n_components;
+    halp::enum_t<Mode, "Mode"> mode{Mode::Batch};
+    halp::knob_i32<"Solve Every (ticks)", halp::range{1, 1000, 10}> solve_every;
+    halp::enum_t<Solver, "Solver"> solver{Solver::Full};
+    halp::toggle<"Background Fit", halp::toggle_setup{false}> background;
     halp::impulse_button<"Reset"> reset;
   } inputs;
 
   struct outs
   {
     halp::val_port<"Principal Components", std::vector<double>> principal_components;
+    halp::val_port<"Projection", std::vector<double>> projection;
   } outputs;
 
+  // Starts the background fit worker
+  void prepare(halp::setup info);
   void operator()();
 
 private:
+  // Matrices reused from one fit to the next
+  struct Workspace
+  {
+    Eigen::MatrixXd centered_data;
+    Eigen::MatrixXd covariance;
+    Eigen::MatrixXd components;
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver;
+    algorithms::TopEigenSolver top_solver;
+  };
+
+  struct FitJob
+  {
+    // Batch: the rows to decompose. Streaming: the covariance to decompose.
+    std::vector<double> data;
+    Eigen::MatrixXd covariance;
+    bool streaming{false};
+    Solver solver{Solver::Full};
+    int n_features{0};
+    int n_components{0};
+    unsigned generation{0};
+  };
+
+  struct FitResult
+  {
+    std::vector<double> components;
+    unsigned generation{0};
+    bool valid{false};
+  };
+
+  // Fills `components` (n_features x n_components, column-major) from the
+  // row-major `data`; false if the data cannot be decomposed or if `stop`
+  // was requested
+  static bool fit(
+      const std::vector<double>& data, int n_features, int n_components,
+      Solver solver, Workspace& ws, std::vector<double>& components,
+      std::stop_token stop = {});
+
+  // Same, from a covariance matrix
+  static bool solve_covariance(
+      const Eigen::MatrixXd& covariance, int n_components, Solver solver,
+      Workspace& ws, std::vector<double>& components);
+
+  void run_batch();
+  void run_streaming();
+  void run_background(bool streaming);
+
+  // Accumulate the rows of `data` into the running mean and scatter matrix
+  void update_statistics(const std::vector<double>& data, int n_features);
+  void reset_statistics();
+
+  // Project the incoming rows, centered on `mean`, onto the current components
+  void project(const Eigen::VectorXd& mean);
+
   std::vector<double> m_principal_components;
-  bool m_is_computed{false};
-
-  mutable Eigen::MatrixXd m_data_matrix;
-  mutable Eigen::MatrixXd m_centered_data;
-  mutable Eigen::MatrixXd m_covariance;
-  mutable Eigen::MatrixXd m_components;
-  mutable Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> m_eigen_solver;
-  mutable int m_cached_n_samples{0};
-  mutable int m_cached_n_features{0};
+
+  Workspace m_workspace;
+
+  // Streaming statistics (Chan et al. batched update of Welford's algorithm)
+  Eigen::VectorXd m_mean;
+  Eigen::MatrixXd m_scatter;
+  Eigen::VectorXd m_batch_mean;
+  Eigen::RowVectorXd m_mean_projection;
+  double m_count{0.0};
+  int m_ticks_since_solve{0};
+  bool m_solve_queued{false};
+
+  // Background fits carry the generation they were started in; one that
+  // finishes after a reset or a newer synchronous fit is dropped
+  using Fitter = algorithms::AsyncFit<FitJob, FitResult>;
+  std::unique_ptr<Fitter> m_fitter;
+  FitResult m_fit_result;
+  unsigned m_generation{0};
 };
 
 }
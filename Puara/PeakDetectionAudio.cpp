@@ -0,0 +1,54 @@
+#include "PeakDetectionAudio.hpp"
+
+namespace puara_gestures::objects
+{
+void PeakDetectionAudio::prepare(halp::setup info)
+{
+  setup = info;
+
+  // Force the thresholds to be applied on the first block
+  trig_watch = {};
+  reload_watch = {};
+  fallback_watch = {};
+}
+
+void PeakDetectionAudio::operator()(halp::tick t)
+{
+  const double* in = inputs.audio.channel;
+  double* out[4]{};
+  out[PEAK_MAX] = outputs.peak_max.channel;
+  out[PEAK_MIN] = outputs.peak_min.channel;
+  out[PEAK_RISING] = outputs.peak_rising.channel;
+  out[PEAK_FALLING] = outputs.peak_falling.channel;
+  if(!in || t.frames <= 0)
+    return;
+
+  // Parameters are checked once per block
+  const bool trig_changed = trig_watch.changed(inputs.trig_thresh);
+  const bool reload_changed = reload_watch.changed(inputs.reload_thresh);
+  const bool fallback_changed = fallback_watch.changed(inputs.fallback_tol);
+
+  for(auto& d : det)
+  {
+    if(trig_changed)
+      d.triggerThreshold(inputs.trig_thresh);
+    if(reload_changed)
+      d.reloadThreshold(inputs.reload_thresh);
+    if(fallback_changed)
+      d.fallbackTolerance(inputs.fallback_tol);
+  }
+
+  // Read each sample before writing the gates: hosts may process in place
+  for(int i = 0; i < t.frames; ++i)
+  {
+    const float v = static_cast<float>(in[i]);
+    for(int k = 0; k < 4; ++k)
+    {
+      const bool peak = det[k].put(v);
+      if(out[k])
+        out[k][i] = peak ? 1.0 : 0.0;
+    }
+  }
+}
+
+} // namespace puara_gestures::objects
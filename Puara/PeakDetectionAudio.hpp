@@ -0,0 +1,67 @@
+#pragma once
+
+#include "3rdparty/extras/PeakDetector.h"
+
+#include <array>
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+#include "halp_utils.hpp"
+
+namespace puara_gestures::objects
+{
+// audio-rate version of PeakDetection: sample-accurate triggers as audio gates
+class PeakDetectionAudio
+{
+public:
+  halp_meta(name, "Peak detection (audio)")
+  halp_meta(category, "Analysis/Data")
+  halp_meta(c_name, "Peak_detection_audio")
+  halp_meta(author, "Luana Belinsky (adapted from Sofian Audry’s Plaquette)")
+  halp_meta(
+      description,
+      "Detects peaks in an incoming normalized audio-rate signal. "
+      "Four detectors analyze every sample and output 1 on the sample where a "
+      "rising, falling, maximum or minimum peak is detected, 0 elsewhere. \n"
+      "Input is expected in the range [0, 1]. \n"
+      "Use normalization / scaling objects upstream if needed.")
+  halp_meta(manual_url, "https://plaquette.org/PeakDetector.html")
+  halp_meta(uuid, "74fa0a10-701e-43a1-8ce1-1dfae7c06483")
+
+  struct
+  {
+    halp::audio_channel<"Signal", double> audio;
+
+    halp::knob_f32<"Trigger threshold", halp::range{0.0f, 1.0f, 0.5f}> trig_thresh;
+
+    halp::knob_f32<"Reload threshold", halp::range{0.0f, 1.0f, 0.35f}> reload_thresh;
+
+    halp::knob_f32<"Fallback tolerance", halp::range{0.0, 1.0, 0.10f}> fallback_tol;
+  } inputs;
+
+  struct
+  {
+    halp::audio_channel<"Peak max", double> peak_max;
+    halp::audio_channel<"Peak min", double> peak_min;
+    halp::audio_channel<"Peak rising", double> peak_rising;
+    halp::audio_channel<"Peak falling", double> peak_falling;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info);
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+private:
+  // Index directly by the enum: 0=MAX, 1=MIN, 2=RISING, 3=FALLING
+  std::array<PeakDetector, 4> det{
+      PeakDetector{0.5f, PEAK_MAX}, PeakDetector{0.5f, PEAK_MIN},
+      PeakDetector{0.5f, PEAK_RISING}, PeakDetector{0.5f, PEAK_FALLING}};
+
+  halp::ParameterWatcher<float> trig_watch;
+  halp::ParameterWatcher<float> reload_watch;
+  halp::ParameterWatcher<float> fallback_watch;
+};
+
+} // namespace puara_gestures::objects
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "statistics_algorithms.hpp"
+
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 #include <vector>
@@ -39,6 +41,9 @@ public:
   } outputs;
 
   void operator()();
+
+private:
+  algorithms::BandPowerPlan m_plan;
 };
 
 }
@@ -1,11 +1,20 @@
 #include "PowerBandEEGAvnd.hpp"
 
-#include "statistics_algorithms.hpp" // Where our helper function lives
+#include <array>
 
-#include <xtensor/containers/xadapt.hpp>
 namespace puara_gestures::objects
 {
 
+// Delta, Theta, Alpha, Low Beta, High Beta, Gamma
+static constexpr std::array<algorithms::FrequencyBand, 6> eeg_bands{{
+    {1.0, 3.0},
+    {3.0, 7.0},
+    {7.0, 12.0},
+    {12.0, 20.0},
+    {20.0, 30.0},
+    {30.0, 50.0},
+}};
+
 void PowerBandEEGAvnd::operator()()
 {
   const auto& psd_vec = inputs.psd.value;
@@ -23,23 +32,18 @@ void PowerBandEEGAvnd::operator()()
     return;
   }
 
-  const auto power_type = inputs.power_type.value;
-
-  auto psd_arr = xt::adapt(psd_vec);
-  auto freq_arr = xt::adapt(freq_vec);
-
-  outputs.delta.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 1.0, 3.0, power_type);
-  outputs.theta.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 3.0, 7.0, power_type);
-  outputs.alpha.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 7.0, 12.0, power_type);
-  outputs.low_beta.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 12.0, 20.0, power_type);
-  outputs.high_beta.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 20.0, 30.0, power_type);
-  outputs.gamma.value
-      = algorithms::calculate_power_in_band(psd_arr, freq_arr, 30.0, 50.0, power_type);
+  // All six bands and the total from one pass over the PSD
+  m_plan.update(freq_vec, eeg_bands);
+
+  std::array<double, eeg_bands.size()> power{};
+  m_plan.compute(psd_vec.data(), power, inputs.power_type.value);
+
+  outputs.delta.value = power[0];
+  outputs.theta.value = power[1];
+  outputs.alpha.value = power[2];
+  outputs.low_beta.value = power[3];
+  outputs.high_beta.value = power[4];
+  outputs.gamma.value = power[5];
 }
 
 }
@@ -41,6 +41,9 @@ public:
   } outputs;
 
   void operator()();
+
+private:
+  algorithms::BandPowerPlan m_plan;
 };
 
 }
@@ -34,6 +34,42 @@ void RateOfChange::drop_oldest_sample()
   --_size;
 }
 
+//==================Ring capacity=============================//
+// sample count mode: the window itself. Time window mode: one sample is pushed
+// per tick, so estimate the ticks per window from the host rate / buffer size.
+std::size_t RateOfChange::wanted_capacity() const
+{
+  double n = 0.0;
+  if(inputs.window_mode == WindowMode::SampleCount)
+  {
+    n = static_cast<double>(std::max<std::size_t>(_cap, 2));
+  }
+  else if(setup.rate > 0.0)
+  {
+    const double tick_rate = setup.frames > 0 ? setup.rate / setup.frames : setup.rate;
+    n = std::ceil(_maxTime * tick_rate) + 2.0;
+  }
+
+  return static_cast<std::size_t>(std::clamp(
+      n, static_cast<double>(kMinCapacity), static_cast<double>(kMaxCapacity)));
+}
+
+void RateOfChange::reserve_ring(std::size_t n)
+{
+  n = std::min(n, kMaxCapacity);
+  if(n <= _physCap)
+    return;
+
+  // unroll the ring so that the oldest sample ends up at index 0
+  std::vector<Sample> grown(n, Sample{0.0f, 0.0, 0.0});
+  for(std::size_t i = 0; i < _size; ++i)
+    grown[i] = _buf[(_head + i) % _physCap];
+
+  _buf = std::move(grown);
+  _physCap = n;
+  _head = 0;
+}
+
 //==================Push sample into buffer=============================//
 // push a new sample into the ring buffer
 void RateOfChange::push(float x, double dt)
@@ -42,10 +78,15 @@ void RateOfChange::push(float x, double dt)
   _lastValue = x;
   _lastValueTime = _totalTime + dt;
 
-  // If physically full, drop oldest (but keep at least 1)
+  // If physically full: in time window mode the tick rate may be higher than
+  // estimated, so grow rather than truncate the window. Otherwise drop oldest
+  // (but keep at least 1).
   if(_size == _physCap)
   {
-    drop_oldest_sample();
+    if(inputs.window_mode == WindowMode::TimeWindow && _physCap < kMaxCapacity)
+      reserve_ring(_physCap * 2);
+    else
+      drop_oldest_sample();
   }
 
   // Append at tail (newest sample)
@@ -150,6 +191,7 @@ void RateOfChange::update_window_from_params()
   if(window_mode_watcher.changed(inputs.window_mode))
   {
     // When switching modes, we need to apply the new policy
+    reserve_ring(wanted_capacity());
     apply_window_policy();
   }
 
@@ -163,6 +205,7 @@ void RateOfChange::update_window_from_params()
         sample_count_v = 2;
 
       _cap = static_cast<std::size_t>(sample_count_v);
+      reserve_ring(wanted_capacity());
       apply_window_policy();
     }
   }
@@ -177,6 +220,7 @@ void RateOfChange::update_window_from_params()
         time_window_v = static_cast<float>(kDtEps);
 
       _maxTime = static_cast<double>(time_window_v);
+      reserve_ring(wanted_capacity());
       apply_window_policy();
     }
   }
@@ -242,12 +286,15 @@ void RateOfChange::prepare(halp::setup info)
 {
   setup = info;
 
-  _buf.assign(_physCap, Sample{0.0f, 0.0, 0.0});
-
   // Initialize from inputs
   _cap = static_cast<std::size_t>(inputs.sample_count);
   _maxTime = static_cast<double>(inputs.time_window);
 
+  // Size the ring from the active window only; it grows when parameters change
+  _physCap = wanted_capacity();
+  _buf.assign(_physCap, Sample{0.0f, 0.0, 0.0});
+  _buf.shrink_to_fit();
+
   _head = 0;
   _size = 0;
   _sumDt = 0.0;
@@ -108,9 +108,11 @@ private:
     double t;  // absolute time since start (seconds)
   };
 
-  // ring buffer storage
+  // ring buffer storage, sized from the active window and grown on demand
+  static constexpr std::size_t kMinCapacity = 16;      // smallest ring allocated
+  static constexpr std::size_t kMaxCapacity = 1000000; // hard upper bound
   std::vector<Sample> _buf;
-  const std::size_t _physCap = 1000000; // physical capacity (allocated size)
+  std::size_t _physCap = 0;             // physical capacity (allocated size)
   std::size_t _cap = 0;                 // logical max samples (for sample count mode)
   std::size_t _head = 0;                // index of oldest in ring
   std::size_t _size = 0;       // number of valid samples in window (<= _physCap)
@@ -131,6 +133,12 @@ private:
   // push one new sample (x, dt) into the ring buffer
   void push(float x, double dt);
 
+  // number of samples the current window needs (sample count or time window)
+  std::size_t wanted_capacity() const;
+
+  // grow the ring to hold at least n samples, keeping their order
+  void reserve_ring(std::size_t n);
+
   // enforce window policy based on current mode
   void apply_window_policy();
 
@@ -15,8 +15,11 @@ void Roll::operator()(halp::tick t)
   const bool smooth_enabled = inputs.enable_smooth;
   const bool wrap_enabled = inputs.enable_wrap;
 
-  // 4. Calling roll calculation.
-  double current_roll_rad = impl.roll(inputs.accel, inputs.gyro, inputs.mag, period_s);
+  // 4. Calling roll calculation, or reading it from the shared orientation.
+  double current_roll_rad
+      = inputs.use_orientation
+            ? inputs.orientation.value.roll
+            : impl.roll(inputs.accel, inputs.gyro, inputs.mag, period_s);
 
   if(unwrap_enabled)
   {
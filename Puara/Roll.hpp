@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Orientation.hpp"
+
 #include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
@@ -25,6 +27,10 @@ public:
     halp::val_port<"Acceleration", puara_gestures::Coord3D> accel;
     halp::val_port<"Gyroscope", puara_gestures::Coord3D> gyro;
     halp::val_port<"Magnetometer", puara_gestures::Coord3D> mag;
+
+    // Skips the sensor fusion and takes the roll of an Orientation node instead
+    halp::val_port<"Orientation", FusedOrientation> orientation;
+    halp::toggle<"Use Orientation"> use_orientation{false};
     halp::toggle<"Enable Unwrap", halp::toggle_setup{.init = true}> enable_unwrap;
     halp::toggle<"Enable Smooth", halp::toggle_setup{.init = true}> enable_smooth;
     halp::toggle<"Enable Wrap", halp::toggle_setup{.init = false}> enable_wrap;
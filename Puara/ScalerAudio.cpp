@@ -0,0 +1,82 @@
+#include "ScalerAudio.hpp"
+
+namespace puara_gestures::objects
+{
+void ScalerAudio::prepare(halp::setup info)
+{
+  setup = info;
+
+  minmax = MinMaxScaler();
+  quantile = QuantileScaler();
+
+  // Force every parameter to be applied on the first block
+  mode_watcher = {};
+  infinite_watcher = {};
+  time_window_watcher = {};
+  span_watcher = {};
+  current_mode = inputs.mode.value;
+  update_parameters();
+}
+
+void ScalerAudio::update_parameters()
+{
+  const Mode mode_value = inputs.mode.value;
+  const bool infinite = inputs.infinite_time_window;
+  const float tw = inputs.time_window;
+  const float span = inputs.span;
+
+  const bool mode_changed = mode_watcher.changed(mode_value);
+  const bool infinite_changed = infinite_watcher.changed(infinite);
+  const bool time_changed = time_window_watcher.changed(tw);
+  const bool span_changed = span_watcher.changed(span);
+
+  // Reset the newly activated scaler so it does not inherit stale stats.
+  if(mode_changed && mode_value != current_mode)
+  {
+    current_mode = mode_value;
+    if(current_mode == Mode::Min_max)
+      minmax.reset();
+    else
+      quantile.reset();
+  }
+
+  if(infinite_changed || time_changed)
+  {
+    const double tw_seconds = infinite ? 0.0 : static_cast<double>(tw);
+    minmax.timeWindow(tw_seconds);
+    quantile.timeWindow(tw_seconds);
+  }
+
+  if(span_changed)
+    quantile.span(span);
+}
+
+void ScalerAudio::operator()(halp::tick t)
+{
+  const double* in = inputs.audio.channel;
+  double* out = outputs.audio.channel;
+  if(!in || !out || t.frames <= 0)
+    return;
+
+  update_parameters();
+
+  // One sample per put(): dt is the sample period
+  const double dt = setup.rate > 0.0 ? 1.0 / setup.rate : 0.0;
+
+  const float low = inputs.out_low;
+  const float high = inputs.out_high;
+
+  if(current_mode == Mode::Min_max)
+  {
+    for(int i = 0; i < t.frames; ++i)
+      out[i] = helpers::map(
+          minmax.put(static_cast<float>(in[i]), dt), 0.0f, 1.0f, low, high);
+  }
+  else
+  {
+    for(int i = 0; i < t.frames; ++i)
+      out[i] = helpers::map(
+          quantile.put(static_cast<float>(in[i]), dt), 0.0f, 1.0f, low, high);
+  }
+}
+} // namespace puara_gestures::objects
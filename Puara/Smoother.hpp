@@ -131,8 +131,7 @@ public:
   using tick = halp::tick;
   void operator()(halp::tick t);
 
-private:
-  // Parameter conversion functions
+  // Parameter conversion functions (shared with MultiSmoother)
   static float alpha_to_time_window(float alpha, float dt);
   static float time_window_to_alpha(float tau_s, float dt);
   static float alpha_to_cutoff(float alpha, float dt);
@@ -140,6 +139,8 @@ private:
   static float time_window_to_cutoff(float tau_s);
   static float cutoff_to_time_window(float fc_hz);
 
+private:
+
   // Internal filter state
   float filtered{0.0f};
   bool has_filtered{false};
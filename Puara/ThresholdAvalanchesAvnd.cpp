@@ -0,0 +1,56 @@
+#include "ThresholdAvalanchesAvnd.hpp"
+
+#include <algorithm>
+
+namespace puara_gestures::objects
+{
+
+void ThresholdAvalanchesAvnd::operator()()
+{
+  const auto& in_vec = inputs.input_array.value;
+  const bool streaming = inputs.streaming.value;
+  const auto channels = static_cast<std::size_t>(std::max(1, inputs.channels.value));
+  outputs.size.value.clear();
+  outputs.duration.value.clear();
+
+  if(!streaming || inputs.reset.value.has_value())
+  {
+    m_tracker.reset();
+  }
+
+  if(in_vec.empty() || in_vec.size() % channels != 0)
+  {
+    return;
+  }
+
+  const auto max_iei_samples
+      = static_cast<std::int64_t>(inputs.time_bin * m_sampling_rate);
+  auto emit = [this](int size, std::int64_t duration) {
+    outputs.size.value.push_back(size);
+    outputs.duration.value.push_back(double(duration) / m_sampling_rate);
+  };
+
+  // The threshold crossings of each frame are counted and handed straight to
+  // the tracker: the binarized signal is never stored
+  const float thresh = inputs.threshold;
+  algorithms::with_threshold(inputs.threshold_type.value, thresh, [&](auto crosses) {
+    const std::size_t frames = in_vec.size() / channels;
+    for(std::size_t f = 0; f < frames; ++f)
+    {
+      const double* frame = in_vec.data() + f * channels;
+      int events = 0;
+      for(std::size_t c = 0; c < channels; ++c)
+        events += crosses(frame[c]);
+      if(events > 0)
+        m_tracker.add(std::int64_t(f), events, max_iei_samples, emit);
+    }
+    m_tracker.advance(std::int64_t(frames));
+  });
+
+  if(streaming)
+    m_tracker.expire(max_iei_samples, emit);
+  else
+    m_tracker.close(emit);
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "avalanche_algorithms.hpp"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <vector>
+
+namespace puara_gestures::objects
+{
+
+class ThresholdAvalanchesAvnd
+{
+public:
+  halp_meta(name, "Threshold Avalanches")
+  halp_meta(category, "Analysis/Data")
+  halp_meta(c_name, "puara_threshold_avalanches_avnd")
+  halp_meta(
+      description,
+      "Binarize followed by Avalanches in a single node, on a multichannel "
+      "signal (interleaved, frame by frame). A frame is active when any channel "
+      "crosses the threshold; an avalanche is a run of active frames separated "
+      "by at most Time Bin, and its size is the number of threshold crossings "
+      "it contains. Outputs the avalanches that ended during the tick; in "
+      "Streaming mode they may span several input arrays.")
+  halp_meta(manual_url, "https://github.com/dav0dea/goofi-pipe")
+  halp_meta(uuid, "e0eef57c-28c0-48a5-8c26-7430de0d0679")
+
+  using ThresholdType = algorithms::ThresholdType;
+
+  struct ins
+  {
+    halp::val_port<"Input", std::vector<double>> input_array;
+    halp::knob_i32<"Channels", halp::range{1, 64, 1}> channels;
+    halp::knob_f32<"Threshold", halp::range{0.0, 5.0, 2.0}> threshold;
+    halp::enum_t<ThresholdType, "Threshold Type"> threshold_type{ThresholdType::Both};
+    halp::knob_f32<"Time Bin (s)", halp::range{0.0, 0.05, 0.008}> time_bin;
+    halp::toggle<"Streaming"> streaming{false};
+    halp::impulse_button<"Reset"> reset;
+  } inputs;
+
+  struct outs
+  {
+    halp::val_port<"Size", std::vector<double>> size;
+    halp::val_port<"Duration (s)", std::vector<double>> duration;
+  } outputs;
+
+  void prepare(halp::setup& setup) { m_sampling_rate = setup.rate; }
+
+  void operator()();
+
+private:
+  double m_sampling_rate{1000.0};
+  algorithms::AvalancheTracker m_tracker;
+};
+
+}
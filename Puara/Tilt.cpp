@@ -4,6 +4,11 @@ namespace puara_gestures::objects
 {
 void Tilt::operator()(halp::tick t)
 {
+  if(inputs.use_orientation)
+  {
+    outputs.output.value = inputs.orientation.value.tilt;
+    return;
+  }
 
   if(setup.rate <= 0.0 || t.frames <= 0)
   {
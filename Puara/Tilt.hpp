@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Orientation.hpp"
+
 #include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
@@ -25,6 +27,11 @@ public:
     halp::val_port<"Acceleration", puara_gestures::Coord3D> accel;
     halp::val_port<"Gyrosocope", puara_gestures::Coord3D> gyro;
     halp::val_port<"Magnetometer", puara_gestures::Coord3D> mag;
+
+    // Output of an Orientation node, used instead of the sensors when enabled
+    // so that the fusion runs once for both Tilt and Roll
+    halp::val_port<"Orientation", FusedOrientation> orientation;
+    halp::toggle<"Use Orientation"> use_orientation{false};
   } inputs;
 
   struct
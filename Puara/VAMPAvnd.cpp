@@ -1,14 +1,28 @@
 #include "VAMPAvnd.hpp"
 
+#include <algorithm>
+
 namespace puara_gestures::objects
 {
 
 VAMPAvnd::VAMPAvnd()
 {
-  m_current_epoch = xt::xarray<double>::from_shape({0, 0});
+  resize_history(std::max(1, inputs.history.value));
   refit_model();
 }
 
+void VAMPAvnd::prepare(halp::setup)
+{
+  if(m_solver)
+    return;
+
+  m_solver = std::make_unique<Solver>(
+      [](const SolveJob& job, SolveResult& result, std::stop_token) {
+    result.valid = algorithms::VampModel::solve(job.covariances, result.transform);
+    result.generation = job.generation;
+  });
+}
+
 void VAMPAvnd::operator()()
 {
   if(inputs.reset.value.has_value())
@@ -16,10 +30,31 @@ void VAMPAvnd::operator()()
     reset_state();
   }
 
-  if(inputs.time_lag.value != m_model->lag() || inputs.n_dims.value != m_model->dims())
+  if(inputs.time_lag.value != m_model->lag())
   {
     refit_model();
   }
+  else if(inputs.n_dims.value != m_model->dims())
+  {
+    // Same covariances, only the number of kept components changes
+    m_model->set_dims(inputs.n_dims.value);
+    ++m_generation;
+    if(m_epoch_count > 0)
+      request_solve();
+  }
+  m_model->set_forgetting(inputs.forgetting.value);
+
+  const std::size_t max_history = std::max(1, inputs.history.value);
+  if(m_buffer.size() != max_history)
+  {
+    resize_history(max_history);
+  }
+
+  // Epochs completed on this tick are solved from the next one on
+  if(m_solver)
+  {
+    update_background();
+  }
 
   const auto& input_vec = inputs.data.value;
   const int n_channels = inputs.n_channels.value;
@@ -30,76 +65,142 @@ void VAMPAvnd::operator()()
     return;
   }
 
-  size_t n_samples = input_vec.size() / n_channels;
-  auto input_arr = xt::adapt(
-      input_vec.data(), input_vec.size(), xt::no_ownership(),
-      std::vector<size_t>{n_samples, (size_t)n_channels});
+  const int n_samples = int(input_vec.size() / n_channels);
 
   if(inputs.collect.value)
   {
-    if(m_current_epoch.size() == 0 || m_current_epoch.dimension() == 0)
-    {
-      m_current_epoch = input_arr;
-    }
-    else
+    // A new channel count, epoch size or lag restarts the current epoch
+    if(n_channels != m_epoch_channels
+       || inputs.epoch_size.value + inputs.time_lag.value != m_epoch_rows)
     {
-      // Ensure both arrays have the same number of dimensions and channels
-      if(m_current_epoch.shape()[1] == input_arr.shape()[1])
-      {
-        m_current_epoch = xt::concatenate(xt::xtuple(m_current_epoch, input_arr), 0);
-      }
-      else
-      {
-        // If channel count mismatch, restart with new data
-        m_current_epoch = input_arr;
-      }
+      resize_epoch(n_channels);
     }
 
-    const int target_epoch_size = inputs.epoch_size.value + inputs.time_lag.value;
-    if(m_current_epoch.shape()[0] >= target_epoch_size)
+    // Copy the incoming rows into the epoch; every time it is full it is fitted
+    // and the remaining rows start the next one
+    int row = 0;
+    while(row < n_samples)
     {
-      // Take only the required amount of data
-      auto epoch_data
-          = xt::view(m_current_epoch, xt::range(0, target_epoch_size), xt::all());
-      xt::xarray<double> epoch_copy = epoch_data;
+      const int count = std::min(n_samples - row, m_epoch_rows - m_epoch_fill);
+      std::copy_n(
+          input_vec.data() + std::size_t(row) * n_channels,
+          std::size_t(count) * n_channels,
+          m_epoch.data() + std::size_t(m_epoch_fill) * n_channels);
+      m_epoch_fill += count;
+      row += count;
 
-      m_buffer.push_back(epoch_copy);
-      m_model->partial_fit(epoch_copy);
-
-      // Only solve if we have enough data
-      if(m_buffer.size() >= 2) // Need at least 2 epochs for meaningful VAMP
+      if(m_epoch_fill == m_epoch_rows)
       {
-        m_model->solve();
-      }
-      if(m_current_epoch.shape()[0] > target_epoch_size)
-      {
-        auto remaining = xt::view(
-            m_current_epoch, xt::range(target_epoch_size, m_current_epoch.shape()[0]),
-            xt::all());
-        m_current_epoch = remaining;
-      }
-      else
-      {
-        m_current_epoch = xt::xarray<double>::from_shape({0, (size_t)n_channels});
+        fit_epoch();
+        m_epoch_fill = 0;
       }
     }
   }
 
-  if(m_model->is_fitted())
+  // A projection solved for another channel count cannot be applied: zeros
+  // until the model is solved again on the new channels
+  if(m_model->is_fitted() && m_model->features() == n_channels)
   {
-    auto comps_arr = m_model->transform(input_arr);
-    if(comps_arr.size() > 0)
+    const int n_comps = m_model->components();
+    outputs.comps.value.resize(std::size_t(n_samples) * n_comps);
+    if(n_comps > 0)
     {
-      outputs.comps.value.assign(comps_arr.begin(), comps_arr.end());
-    }
-    else
-    {
-      outputs.comps.value.clear();
+      m_model->transform(
+          input_vec.data(), n_samples, n_channels, outputs.comps.value.data());
     }
   }
   else
   {
-    outputs.comps.value.assign(n_samples * inputs.n_dims.value, 0.0);
+    outputs.comps.value.assign(std::size_t(n_samples) * inputs.n_dims.value, 0.0);
+  }
+}
+
+void VAMPAvnd::resize_epoch(int n_channels)
+{
+  m_epoch_channels = n_channels;
+  m_epoch_rows = inputs.epoch_size.value + inputs.time_lag.value;
+  m_epoch.resize(std::size_t(m_epoch_rows) * n_channels);
+  m_epoch_fill = 0;
+}
+
+void VAMPAvnd::resize_history(std::size_t max_history)
+{
+  // Unroll the ring oldest first; shrinking drops the oldest epochs
+  std::rotate(m_buffer.begin(), m_buffer.begin() + m_buffer_head, m_buffer.end());
+  m_buffer_head = 0;
+  if(m_buffer_count > max_history)
+  {
+    std::rotate(
+        m_buffer.begin(), m_buffer.begin() + (m_buffer_count - max_history),
+        m_buffer.begin() + m_buffer_count);
+    m_buffer_count = max_history;
+  }
+  m_buffer.resize(max_history);
+}
+
+void VAMPAvnd::fit_epoch()
+{
+  m_model->partial_fit(m_epoch.data(), m_epoch_rows, m_epoch_channels);
+
+  // Store a copy in the history ring, reusing the oldest slot once full
+  const std::size_t max_history = m_buffer.size();
+  const std::size_t slot = (m_buffer_head + m_buffer_count) % max_history;
+  auto& stored = m_buffer[slot];
+  stored.data.assign(m_epoch.begin(), m_epoch.end());
+  stored.rows = m_epoch_rows;
+  stored.channels = m_epoch_channels;
+  if(m_buffer_count < max_history)
+  {
+    ++m_buffer_count;
+  }
+  else
+  {
+    m_buffer_head = (m_buffer_head + 1) % max_history;
+  }
+
+  ++m_epoch_count;
+  ++m_epochs_since_solve;
+
+  // Only solve if we have enough data, and at most every `solve_every` epochs
+  if(m_epoch_count >= 2 // Need at least 2 epochs for meaningful VAMP
+     && m_epochs_since_solve >= inputs.solve_every.value)
+  {
+    request_solve();
+    m_epochs_since_solve = 0;
+  }
+}
+
+void VAMPAvnd::request_solve()
+{
+  // The worker is started by prepare(): without it, solve on the tick
+  if(inputs.background.value && m_solver)
+  {
+    m_solve_queued = true;
+  }
+  else
+  {
+    // A background solve still running is now older than the model
+    ++m_generation;
+    m_model->solve();
+  }
+}
+
+void VAMPAvnd::update_background()
+{
+  if(m_solver->poll(m_solve_result) && m_solve_result.valid
+     && m_solve_result.generation == m_generation)
+  {
+    m_model->set_transform(m_solve_result.transform);
+  }
+
+  // Only the latest covariances matter: queued requests collapse into one
+  if(m_solve_queued && m_solver->idle())
+  {
+    auto& job = m_solver->job();
+    m_model->covariances(job.covariances);
+    job.generation = m_generation;
+    m_solver->submit();
+    m_solve_queued = false;
   }
 }
 
@@ -107,21 +208,34 @@ void VAMPAvnd::refit_model()
 {
   m_model = std::make_unique<algorithms::VampModel>(
       inputs.time_lag.value, inputs.n_dims.value);
-  for(const auto& epoch : m_buffer)
+  m_model->set_forgetting(inputs.forgetting.value);
+
+  // Epochs older than the history are gone: the new model restarts from the
+  // ones still kept, oldest first
+  for(std::size_t i = 0; i < m_buffer_count; ++i)
   {
-    m_model->partial_fit(epoch);
+    const auto& epoch = m_buffer[(m_buffer_head + i) % m_buffer.size()];
+    m_model->partial_fit(epoch.data.data(), epoch.rows, epoch.channels);
   }
-  if(!m_buffer.empty())
+  m_epoch_count = (long long)m_buffer_count;
+  m_epochs_since_solve = 0;
+  ++m_generation;
+  m_solve_queued = false;
+  if(m_buffer_count > 0)
   {
-    m_model->solve();
+    request_solve();
   }
 }
 
 void VAMPAvnd::reset_state()
 {
-  m_buffer.clear();
-  const int n_channels = inputs.n_channels.value;
-  m_current_epoch = xt::xarray<double>::from_shape({0, (size_t)n_channels});
+  m_buffer_head = 0;
+  m_buffer_count = 0;
+  m_epoch_count = 0;
+  m_epochs_since_solve = 0;
+  m_epoch_fill = 0;
+  ++m_generation;
+  m_solve_queued = false;
   m_model->reset();
 }
 
@@ -1,6 +1,8 @@
 #pragma once
+#include "async_fit.hpp"
 #include "vamp_algorithms.hpp"
 
+#include <halp/audio.hpp>
 #include <halp/controls.hpp>
 #include <halp/meta.hpp>
 
@@ -15,7 +17,13 @@ public:
   halp_meta(name, "VAMP")
   halp_meta(category, "Analysis/Data")
   halp_meta(c_name, "puara_vamp_avnd")
-  halp_meta(description, "Finds slowest components in a time-series using VAMP.")
+  halp_meta(
+      description,
+      "Finds slowest components in a time-series using VAMP. "
+      "Covariances are accumulated over every epoch, optionally with exponential "
+      "forgetting; only the last History epochs are kept to refit when the time "
+      "lag changes. The model is re-solved every Solve Every epochs, on a worker "
+      "thread with Background Solve (the previous projection is used meanwhile).")
   halp_meta(uuid, "3ebf910a-330f-43d8-8958-287b6f191c22")
 
   struct
@@ -25,6 +33,10 @@ public:
     halp::knob_i32<"Time Lag (samples)", halp::range{1, 300, 10}> time_lag;
     halp::knob_i32<"Num Dimensions", halp::range{1, 8, 2}> n_dims;
     halp::knob_i32<"Epoch Size (samples)", halp::range{2, 1000, 256}> epoch_size;
+    halp::knob_i32<"History (epochs)", halp::range{1, 1000, 64}> history;
+    halp::knob_f32<"Forgetting Factor", halp::range{0.5, 1.0, 1.0}> forgetting;
+    halp::knob_i32<"Solve Every (epochs)", halp::range{1, 100, 1}> solve_every;
+    halp::toggle<"Background Solve", halp::toggle_setup{false}> background;
     halp::toggle<"Collect Data", halp::toggle_setup{true}> collect;
     halp::impulse_button<"Reset Model"> reset;
   } inputs;
@@ -35,14 +47,68 @@ public:
   } outputs;
 
   VAMPAvnd();
+  // Starts the background solve worker
+  void prepare(halp::setup info);
   void operator()();
 
 private:
   void refit_model();
   void reset_state();
+  // Resize the epoch buffer for the current epoch size, lag and channels
+  void resize_epoch(int n_channels);
+  // Resize the history ring, keeping the newest epochs
+  void resize_history(std::size_t max_history);
+  // Fit the epoch buffer, store it in the history and solve if due
+  void fit_epoch();
+  // Solve now, or queue a background solve of the current covariances
+  void request_solve();
+  // Install a finished background solve and start the queued one
+  void update_background();
+
   std::unique_ptr<algorithms::VampModel> m_model;
-  xt::xarray<double> m_current_epoch;
-  std::vector<xt::xarray<double>> m_buffer;
+
+  // Epoch being assembled: (epoch_size + time_lag) x n_channels, row-major,
+  // fed to the model in place once full
+  std::vector<double> m_epoch;
+  int m_epoch_rows{0};
+  int m_epoch_channels{0};
+  int m_epoch_fill{0};
+
+  // Last `history` epochs, only replayed when the time lag changes; the
+  // model itself keeps running covariance sums of every epoch seen.
+  // Used as a ring: slots are reused once the history is full.
+  struct Epoch
+  {
+    std::vector<double> data;
+    int rows{0};
+    int channels{0};
+  };
+  std::vector<Epoch> m_buffer;
+  std::size_t m_buffer_head{0};
+  std::size_t m_buffer_count{0};
+
+  long long m_epoch_count{0};
+  int m_epochs_since_solve{0};
+
+  // Background solve: a snapshot of the covariances goes to the worker, the
+  // projection comes back. The generation discards results computed for a
+  // model that has since been reset, refitted or solved synchronously.
+  struct SolveJob
+  {
+    algorithms::VampModel::Covariances covariances;
+    unsigned generation{0};
+  };
+  struct SolveResult
+  {
+    Eigen::MatrixXd transform;
+    unsigned generation{0};
+    bool valid{false};
+  };
+  using Solver = algorithms::AsyncFit<SolveJob, SolveResult>;
+  std::unique_ptr<Solver> m_solver;
+  SolveResult m_solve_result;
+  unsigned m_generation{0};
+  bool m_solve_queued{false};
 };
 
 }
@@ -0,0 +1,60 @@
+#include "WelchPSDAvnd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace puara_gestures::objects
+{
+
+void WelchPSDAvnd::prepare(halp::setup info)
+{
+  setup = info;
+
+  // The first tick always configures the estimator for the new rate
+  m_segment_watcher = {};
+}
+
+void WelchPSDAvnd::configure()
+{
+  std::size_t n = 16;
+  while(n < std::size_t(std::max(16, int(inputs.segment))))
+    n <<= 1;
+
+  const double overlap = std::clamp(double(inputs.overlap), 0.0, 0.95);
+  const auto hop = std::max<std::size_t>(1, std::size_t(std::lround(n * (1.0 - overlap))));
+
+  m_welch.configure(
+      n, hop, std::size_t(std::max(1, int(inputs.averages))), inputs.window.value,
+      setup.rate, inputs.remove_mean);
+
+  // Sized once here, written in place afterwards
+  outputs.psd.value.assign(m_welch.psd().size(), 0.0);
+  outputs.frequencies.value = m_welch.frequencies();
+}
+
+void WelchPSDAvnd::operator()(halp::tick t)
+{
+  // Evaluate every watcher so they all record the current value
+  bool changed = m_segment_watcher.changed(inputs.segment);
+  changed |= m_overlap_watcher.changed(inputs.overlap);
+  changed |= m_averages_watcher.changed(inputs.averages);
+  changed |= m_window_watcher.changed(inputs.window.value);
+  changed |= m_remove_mean_watcher.changed(inputs.remove_mean);
+
+  if(changed)
+    configure();
+  else if(inputs.reset.value.has_value())
+    m_welch.reset();
+
+  const double* in = inputs.audio.channel;
+  if(!in || t.frames <= 0)
+    return;
+
+  if(m_welch.push(in, std::size_t(t.frames)))
+  {
+    const auto& psd = m_welch.psd();
+    std::copy(psd.begin(), psd.end(), outputs.psd.value.begin());
+  }
+}
+
+}
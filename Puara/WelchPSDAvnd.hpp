@@ -0,0 +1,70 @@
+#pragma once
+
+#include "halp_utils.hpp"
+#include "spectral_algorithms.hpp"
+
+#include <halp/audio.hpp>
+#include <halp/controls.hpp>
+#include <halp/meta.hpp>
+
+#include <vector>
+
+namespace puara_gestures::objects
+{
+// Streaming Welch PSD estimate, output ports match PowerBandAvnd / PowerBandEEGAvnd
+class WelchPSDAvnd
+{
+public:
+  halp_meta(name, "Welch PSD")
+  halp_meta(category, "Analysis/Data processing")
+  halp_meta(c_name, "puara_welch_psd")
+  halp_meta(
+      description,
+      "Estimates the power spectral density of an incoming signal with Welch's "
+      "method: overlapping windowed segments are transformed with an FFT and "
+      "their periodograms averaged. Outputs a PSD (V²/Hz) and the matching "
+      "frequency vector, ready for the Power Band nodes. "
+      "The segment size is rounded up to a power of two.")
+  halp_meta(manual_url, "https://docs.scipy.org/doc/scipy/reference/generated/scipy.signal.welch.html")
+  halp_meta(uuid, "d6e2ad80-89a1-4078-ab11-43ba8bc597b9")
+
+  struct ins
+  {
+    halp::audio_channel<"Signal", double> audio;
+
+    // --- Parameters ---
+    halp::spinbox_i32<"Segment size", halp::range{16, 8192, 256}> segment;
+    halp::knob_f32<"Overlap", halp::range{0.0, 0.95, 0.5}> overlap;
+    halp::spinbox_i32<"Averaged segments", halp::range{1, 64, 8}> averages;
+    halp::enum_t<algorithms::SpectralWindow, "Window"> window{
+        algorithms::SpectralWindow::Hann};
+    halp::toggle<"Remove mean", halp::toggle_setup{true}> remove_mean;
+    halp::impulse_button<"Reset"> reset;
+  } inputs;
+
+  struct outs
+  {
+    halp::val_port<"PSD", std::vector<double>> psd;
+    halp::val_port<"Frequencies", std::vector<double>> frequencies;
+  } outputs;
+
+  halp::setup setup;
+  void prepare(halp::setup info);
+
+  using tick = halp::tick;
+  void operator()(halp::tick t);
+
+private:
+  // Rebuild the window, FFT tables and buffers for the current parameters
+  void configure();
+
+  algorithms::WelchPSD m_welch;
+
+  halp::ParameterWatcher<int> m_segment_watcher;
+  halp::ParameterWatcher<float> m_overlap_watcher;
+  halp::ParameterWatcher<int> m_averages_watcher;
+  halp::ParameterWatcher<algorithms::SpectralWindow> m_window_watcher;
+  halp::ParameterWatcher<bool> m_remove_mean_watcher;
+};
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numbers>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace puara_gestures::algorithms
+{
+// Exact: std::atan2. Fast: |error| < 1e-6 degree. Fastest: |error| < 1e-3 degree.
+enum class AtanAccuracy
+{
+  Exact,
+  Fast,
+  Fastest
+};
+
+namespace detail
+{
+// Odd minimax polynomials for atan(a) / a on [0, 1], in s = a²
+// (Abramowitz & Stegun 4.4.49 and 4.4.47)
+template <AtanAccuracy Accuracy>
+struct AtanPolynomial;
+
+template <>
+struct AtanPolynomial<AtanAccuracy::Fast>
+{
+  static constexpr double c[] = {1.0,           -0.3333314528, 0.1999355085,
+                                 -0.1420889944, 0.1065626393,  -0.0752896400,
+                                 0.0429096138,  -0.0161657367, 0.0028662257};
+};
+
+template <>
+struct AtanPolynomial<AtanAccuracy::Fastest>
+{
+  static constexpr double c[] = {0.9998660, -0.3302995, 0.1801410, -0.0851330, 0.0208351};
+};
+
+// Horner's scheme on scalars or SIMD registers: set broadcasts a coefficient,
+// mul_add(p, s, c) is p * s + c
+template <AtanAccuracy Accuracy, typename T, typename Set, typename MulAdd>
+T atan_polynomial(T s, Set set, MulAdd mul_add)
+{
+  constexpr auto& c = AtanPolynomial<Accuracy>::c;
+  constexpr int n = int(std::size(c));
+  T p = set(c[n - 1]);
+  for (int k = n - 2; k >= 0; --k)
+    p = mul_add(p, s, set(c[k]));
+  return p;
+}
+
+// atan2(y, x) in degrees, in [0, 360). Branchless: the octant is folded into
+// [0, 1] and unfolded with selects, so that it compiles to straight-line code.
+template <AtanAccuracy Accuracy>
+double atan2_degrees(double y, double x)
+{
+  const double ax = std::abs(x);
+  const double ay = std::abs(y);
+  const double hi = std::max(ax, ay);
+  const double a = hi > 0.0 ? std::min(ax, ay) / hi : 0.0;
+  double r = a * atan_polynomial<Accuracy>(
+                 a * a, [](double c) { return c; },
+                 [](double p, double s, double c) { return p * s + c; });
+  r = ay > ax ? std::numbers::pi / 2 - r : r;
+  r = std::signbit(x) ? std::numbers::pi - r : r;
+  const double deg = std::copysign(r, y) * (180.0 / std::numbers::pi);
+  return deg < 0.0 ? deg + 360.0 : deg;
+}
+
+template <AtanAccuracy Accuracy>
+void vector_angles(const double* p1, const double* p2, std::size_t n, double* out)
+{
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  // Two angles per step, same operations as atan2_degrees
+  const __m128d sign = _mm_set1_pd(-0.0);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d half_pi = _mm_set1_pd(std::numbers::pi / 2);
+  const __m128d pi = _mm_set1_pd(std::numbers::pi);
+  const __m128d to_degrees = _mm_set1_pd(180.0 / std::numbers::pi);
+  const __m128d full_turn = _mm_set1_pd(360.0);
+  auto select = [](__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+  };
+
+  for (; i + 2 < n; i += 2) {
+    const __m128d x = _mm_sub_pd(_mm_loadu_pd(p2 + i), _mm_loadu_pd(p1 + i));
+    const __m128d y = _mm_sub_pd(_mm_loadu_pd(p2 + i + 1), _mm_loadu_pd(p1 + i + 1));
+    const __m128d ax = _mm_andnot_pd(sign, x);
+    const __m128d ay = _mm_andnot_pd(sign, y);
+    const __m128d hi = _mm_max_pd(ax, ay);
+
+    // 0 / 0 is masked to 0
+    const __m128d a
+        = _mm_and_pd(_mm_div_pd(_mm_min_pd(ax, ay), hi), _mm_cmpgt_pd(hi, zero));
+    const __m128d p = atan_polynomial<Accuracy>(
+        _mm_mul_pd(a, a), [](double c) { return _mm_set1_pd(c); },
+        [](__m128d p, __m128d s, __m128d c) { return _mm_add_pd(_mm_mul_pd(p, s), c); });
+    __m128d r = _mm_mul_pd(a, p);
+    r = select(_mm_cmpgt_pd(ay, ax), _mm_sub_pd(half_pi, r), r);
+
+    // Sign bit of x broadcast over each lane, so that -0 counts as negative
+    const __m128d x_negative = _mm_castsi128_pd(_mm_shuffle_epi32(
+        _mm_srai_epi32(_mm_castpd_si128(x), 31), _MM_SHUFFLE(3, 3, 1, 1)));
+    r = select(x_negative, _mm_sub_pd(pi, r), r);
+
+    const __m128d deg = _mm_mul_pd(_mm_or_pd(r, _mm_and_pd(y, sign)), to_degrees);
+    _mm_storeu_pd(
+        out + i, _mm_add_pd(deg, _mm_and_pd(_mm_cmplt_pd(deg, zero), full_turn)));
+  }
+#endif
+  for (; i + 1 < n; ++i) {
+    out[i] = atan2_degrees<Accuracy>(p2[i + 1] - p1[i + 1], p2[i] - p1[i]);
+  }
+}
+}
+
+// Angle in degrees, in [0, 360), of each pair (d[i], d[i + 1]) of consecutive
+// elements of d = p2 - p1, without storing d: out receives n - 1 angles.
+inline void vector_angles(
+    const double* p1, const double* p2, std::size_t n, double* out, AtanAccuracy accuracy)
+{
+  switch (accuracy) {
+    case AtanAccuracy::Fast:
+      return detail::vector_angles<AtanAccuracy::Fast>(p1, p2, n, out);
+    case AtanAccuracy::Fastest:
+      return detail::vector_angles<AtanAccuracy::Fastest>(p1, p2, n, out);
+    case AtanAccuracy::Exact:
+    default:
+      for (std::size_t i = 0; i + 1 < n; ++i) {
+        const double x = p2[i] - p1[i];
+        const double y = p2[i + 1] - p1[i + 1];
+        const double angle_deg = std::atan2(y, x) * 180.0 / std::numbers::pi;
+        double normalized_deg = std::fmod(angle_deg, 360.0);
+        if (normalized_deg < 0) {
+          normalized_deg += 360.0;
+        }
+        out[i] = normalized_deg;
+      }
+      return;
+  }
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define PUARA_ASYNC_FIT_NO_THREADS 1
+#endif
+
+namespace puara_gestures::algorithms
+{
+// Runs a model fit on a worker thread so that it never stalls the tick.
+//
+// The tick thread fills job() while the worker is idle and calls submit().
+// The worker computes into its own result buffer; poll() then swaps that
+// buffer with the caller's published copy, so the previous model stays in use
+// until the new one is complete. Job and result ownership are handed back and
+// forth through a single atomic state: the tick thread never takes a lock and
+// never waits for the worker. The thread is started by the constructor, so it
+// should be built outside of the tick (e.g. in prepare()). The fit function
+// receives a stop token, requested by the destructor, that long fits should
+// check so that destroying the object does not wait for them to finish.
+template <typename Job, typename Result>
+class AsyncFit
+{
+public:
+  using function_type = std::function<void(const Job&, Result&, std::stop_token)>;
+
+  explicit AsyncFit(function_type f)
+      : m_function(std::move(f))
+  {
+#if !defined(PUARA_ASYNC_FIT_NO_THREADS)
+    m_thread = std::jthread([this](std::stop_token stop) { run(stop); });
+#endif
+  }
+
+  AsyncFit(const AsyncFit&) = delete;
+  AsyncFit& operator=(const AsyncFit&) = delete;
+
+  ~AsyncFit()
+  {
+    if (m_thread.joinable()) {
+      m_thread.request_stop();
+      m_state.store(Stop, std::memory_order_release);
+      m_state.notify_one();
+      m_thread.join();
+    }
+  }
+
+  // True when the worker is free: job() may be written, then submit()ted
+  bool idle() const { return m_state.load(std::memory_order_acquire) == Idle; }
+
+  Job& job() { return m_job; }
+
+  void submit()
+  {
+#if defined(PUARA_ASYNC_FIT_NO_THREADS)
+    m_function(m_job, m_result, {});
+    m_state.store(Ready, std::memory_order_release);
+#else
+    m_state.store(Pending, std::memory_order_release);
+    m_state.notify_one();
+#endif
+  }
+
+  // If a result is ready, swap it into `out` and return true
+  bool poll(Result& out)
+  {
+    if (m_state.load(std::memory_order_acquire) != Ready) {
+      return false;
+    }
+    std::swap(out, m_result);
+    m_state.store(Idle, std::memory_order_release);
+    return true;
+  }
+
+private:
+  enum State : int { Idle, Pending, Ready, Stop };
+
+  void run(std::stop_token stop)
+  {
+    for (;;) {
+      int state = m_state.load(std::memory_order_acquire);
+      while (state != Pending && !stop.stop_requested()) {
+        m_state.wait(state, std::memory_order_acquire);
+        state = m_state.load(std::memory_order_acquire);
+      }
+      if (stop.stop_requested()) {
+        return;
+      }
+
+      m_function(m_job, m_result, stop);
+      m_state.store(Ready, std::memory_order_release);
+    }
+  }
+
+  function_type m_function;
+  Job m_job{};
+  Result m_result{};
+  std::atomic<int> m_state{Idle};
+  std::jthread m_thread;
+};
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "threshold_algorithms.hpp"
+
+#include <cstdint>
+
+namespace puara_gestures::algorithms
+{
+// Groups events into avalanches: runs of events whose successive positions
+// are at most `max_gap` frames apart. A chunk of frames is fed by calling add()
+// for each frame that holds events, then advance() with the chunk length; the
+// open avalanche is carried from one chunk to the next. Closed avalanches are
+// reported through emit(size, duration in frames), size being the total number
+// of events.
+class AvalancheTracker
+{
+public:
+  void reset()
+  {
+    m_open = false;
+    m_position = 0;
+  }
+
+  // `events` (> 0) at frame `offset` of the current chunk, in increasing order
+  template <typename Emit>
+  void add(std::int64_t offset, int events, std::int64_t max_gap, Emit&& emit)
+  {
+    const std::int64_t index = m_position + offset;
+    if (m_open && index - m_last <= max_gap) {
+      m_size += events;
+    } else {
+      close(emit);
+      m_open = true;
+      m_start = index;
+      m_size = events;
+    }
+    m_last = index;
+  }
+
+  void advance(std::int64_t frames) { m_position += frames; }
+
+  // Closes the open avalanche once no later frame can extend it
+  template <typename Emit>
+  void expire(std::int64_t max_gap, Emit&& emit)
+  {
+    if (m_open && m_position - m_last > max_gap) {
+      close(emit);
+    }
+  }
+
+  template <typename Emit>
+  void close(Emit&& emit)
+  {
+    if (m_open) {
+      emit(m_size, m_last - m_start);
+      m_open = false;
+    }
+  }
+
+private:
+  std::int64_t m_position{0};
+  std::int64_t m_start{0};
+  std::int64_t m_last{0};
+  int m_size{0};
+  bool m_open{false};
+};
+
+}
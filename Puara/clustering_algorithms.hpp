@@ -0,0 +1,536 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stop_token>
+#include <vector>
+
+namespace puara_gestures::algorithms
+{
+// Lloyd's k-means on a flat row-major n x d buffer, read in place.
+// Centers are a contiguous k x d matrix. The assignment step processes the
+// data in blocks of rows: the block's dot products with every center come
+// from one matrix product, and argmin_j |x - c_j|² = argmin_j (|c_j|² - 2 x·c_j)
+// needs no per-pair distance loop. Buffers are kept between calls, so
+// iterations do not allocate once the data shape is stable.
+class KMeans
+{
+public:
+  using RowMajorMatrix
+      = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  // Returns false if n rows cannot be split into k clusters.
+  // Centers are seeded with k-means++ from `seed`, so the same data and seed
+  // always give the same clustering. With `warm_start`, the centers of the
+  // previous fit are reused as the starting point when k and d are unchanged,
+  // which usually converges in a few iterations on slowly changing data and
+  // keeps the labels stable from one call to the next.
+  // A stop request abandons the fit between iterations and returns false.
+  bool fit(
+      const double* data, int n, int d, int k, unsigned seed, bool warm_start,
+      std::stop_token stop = {}, int max_iterations = 100)
+  {
+    if (!data || n <= 0 || d <= 0 || k <= 0 || k > n) {
+      return false;
+    }
+
+    const bool reuse = warm_start && m_has_centers && m_centers.rows() == k
+                       && m_centers.cols() == d;
+    resize(n, d, k);
+    if (!reuse) {
+      m_rng.seed(seed);
+      seed_plus_plus(data, n, d, k, m_rng, m_min_dist, m_centers);
+    }
+    m_has_centers = true;
+
+    std::fill(m_labels.begin(), m_labels.end(), -1);
+    for (int iter = 0; iter < max_iterations; ++iter) {
+      if (stop.stop_requested()) {
+        return false;
+      }
+      if (!assign(data, n, d, k)) {
+        break;
+      }
+      update(data, n, d, k);
+    }
+    return true;
+  }
+
+  // Forget the previous centers: the next fit is seeded again
+  void reset() { m_has_centers = false; }
+
+  // Cluster index of every row of the last fit
+  const std::vector<int>& labels() const { return m_labels; }
+
+  // k x d centers of the last fit, row-major
+  const RowMajorMatrix& centers() const { return m_centers; }
+
+  // Greedy k-means++: each new center is the best, by total squared distance,
+  // of a few rows drawn with probability proportional to their squared
+  // distance to the nearest center already chosen. Writes the k seeds
+  // into `centers` (k x d). `min_dist` must hold n values.
+  static void seed_plus_plus(
+      const double* data, int n, int d, int k, std::mt19937& rng,
+      std::vector<double>& min_dist, RowMajorMatrix& centers)
+  {
+    auto sq_dist = [d](const double* a, const double* b) {
+      double sum = 0.0;
+      for (int c = 0; c < d; ++c) {
+        const double diff = a[c] - b[c];
+        sum += diff * diff;
+      }
+      return sum;
+    };
+
+    std::uniform_int_distribution<int> uniform(0, n - 1);
+    std::copy_n(data + std::size_t(uniform(rng)) * d, d, &centers(0, 0));
+
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+      min_dist[i] = sq_dist(data + std::size_t(i) * d, &centers(0, 0));
+      total += min_dist[i];
+    }
+
+    // Same number of trials as scikit-learn
+    const int trials = 2 + int(std::log(double(k)));
+
+    for (int j = 1; j < k; ++j) {
+      int best = -1;
+      double best_total = std::numeric_limits<double>::max();
+      for (int t = 0; t < trials; ++t) {
+        int candidate = uniform(rng);
+        if (total > 0.0) {
+          double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+          candidate = n - 1;
+          for (int i = 0; i < n; ++i) {
+            target -= min_dist[i];
+            if (target < 0.0) {
+              candidate = i;
+              break;
+            }
+          }
+        }
+
+        const double* c = data + std::size_t(candidate) * d;
+        double candidate_total = 0.0;
+        for (int i = 0; i < n; ++i) {
+          candidate_total += std::min(min_dist[i], sq_dist(data + std::size_t(i) * d, c));
+        }
+        if (candidate_total < best_total) {
+          best_total = candidate_total;
+          best = candidate;
+        }
+      }
+
+      std::copy_n(data + std::size_t(best) * d, d, &centers(j, 0));
+      total = 0.0;
+      for (int i = 0; i < n; ++i) {
+        min_dist[i]
+            = std::min(min_dist[i], sq_dist(data + std::size_t(i) * d, &centers(j, 0)));
+        total += min_dist[i];
+      }
+    }
+  }
+
+private:
+  static constexpr int block_rows = 256;
+
+  void resize(int n, int d, int k)
+  {
+    // Eigen and std::vector keep their storage when the size is unchanged
+    m_centers.resize(k, d);
+    m_sums.resize(k, d);
+    m_center_norms.resize(k);
+    m_dots.resize(std::min(n, block_rows), k);
+    m_counts.resize(k);
+    m_labels.resize(n);
+    m_min_dist.resize(n);
+  }
+
+  // Assign every row to its nearest center; true if any label changed
+  bool assign(const double* data, int n, int d, int k)
+  {
+    m_center_norms = m_centers.rowwise().squaredNorm();
+
+    bool changed = false;
+    for (int r0 = 0; r0 < n; r0 += block_rows) {
+      const int rows = std::min(block_rows, n - r0);
+      Eigen::Map<const RowMajorMatrix> x(data + std::size_t(r0) * d, rows, d);
+      m_dots.topRows(rows).noalias() = x * m_centers.transpose();
+
+      for (int i = 0; i < rows; ++i) {
+        int best = 0;
+        double best_dist = std::numeric_limits<double>::max();
+        for (int j = 0; j < k; ++j) {
+          const double dist = m_center_norms[j] - 2.0 * m_dots(i, j);
+          if (dist < best_dist) {
+            best_dist = dist;
+            best = j;
+          }
+        }
+        if (m_labels[r0 + i] != best) {
+          m_labels[r0 + i] = best;
+          changed = true;
+        }
+      }
+    }
+    return changed;
+  }
+
+  // Move every center to the mean of its rows; empty clusters keep their center
+  void update(const double* data, int n, int d, int k)
+  {
+    m_sums.setZero();
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    for (int i = 0; i < n; ++i) {
+      const int j = m_labels[i];
+      const double* row = data + std::size_t(i) * d;
+      double* sum = &m_sums(j, 0);
+      for (int c = 0; c < d; ++c) {
+        sum[c] += row[c];
+      }
+      m_counts[j]++;
+    }
+    for (int j = 0; j < k; ++j) {
+      if (m_counts[j] > 0) {
+        m_centers.row(j) = m_sums.row(j) / double(m_counts[j]);
+      }
+    }
+  }
+
+  RowMajorMatrix m_centers;
+  RowMajorMatrix m_sums;
+  RowMajorMatrix m_dots;
+  Eigen::VectorXd m_center_norms;
+  std::vector<int> m_counts;
+  std::vector<int> m_labels;
+  std::vector<double> m_min_dist;
+  std::mt19937 m_rng;
+  bool m_has_centers{false};
+};
+
+
+// Single-linkage agglomerative clustering of a flat row-major n x d buffer.
+// Single linkage merges the closest clusters first, which is exactly
+// building the minimum spanning tree of the points and removing its k - 1
+// longest edges. The tree is built with Prim's algorithm on distances
+// computed on the fly: O(n²·d) time and O(n) extra memory, instead of
+// rescanning every pair of clusters after each merge.
+class SingleLinkage
+{
+public:
+  using RowMajorMatrix = KMeans::RowMajorMatrix;
+
+  // Returns false if n rows cannot be split into k clusters, or if a stop
+  // was requested while building the tree
+  bool fit(const double* data, int n, int d, int k, std::stop_token stop = {})
+  {
+    if (!data || n <= 0 || d <= 0 || k <= 0 || k > n) {
+      return false;
+    }
+    resize(n, d, k);
+    if (!build_tree(data, n, d, stop)) {
+      return false;
+    }
+
+    // Keep the n - k shortest edges: the k - 1 longest ones separate the clusters
+    const auto kept = m_edges.begin() + (n - k);
+    std::nth_element(m_edges.begin(), kept, m_edges.end(), [](const Edge& a, const Edge& b) {
+      return a.weight < b.weight;
+    });
+    std::iota(m_root.begin(), m_root.end(), 0);
+    for (auto it = m_edges.begin(); it != kept; ++it) {
+      m_root[find(it->a)] = find(it->b);
+    }
+
+    // Number clusters in order of first appearance, and average their rows
+    std::fill(m_cluster_of_root.begin(), m_cluster_of_root.end(), -1);
+    m_centers.setZero();
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    int next_label = 0;
+    for (int i = 0; i < n; ++i) {
+      const int root = find(i);
+      if (m_cluster_of_root[root] < 0) {
+        m_cluster_of_root[root] = next_label++;
+      }
+      const int label = m_cluster_of_root[root];
+      m_labels[i] = label;
+
+      const double* row = data + std::size_t(i) * d;
+      double* center = &m_centers(label, 0);
+      for (int c = 0; c < d; ++c) {
+        center[c] += row[c];
+      }
+      m_counts[label]++;
+    }
+    for (int j = 0; j < k; ++j) {
+      m_centers.row(j) /= double(m_counts[j]);
+    }
+    return true;
+  }
+
+  // Cluster index of every row of the last fit
+  const std::vector<int>& labels() const { return m_labels; }
+
+  // k x d mean of every cluster of the last fit, row-major
+  const RowMajorMatrix& centers() const { return m_centers; }
+
+private:
+  struct Edge
+  {
+    double weight;
+    int a;
+    int b;
+  };
+
+  void resize(int n, int d, int k)
+  {
+    m_min_dist.resize(n);
+    m_parent.resize(n);
+    m_in_tree.resize(n);
+    m_edges.resize(n - 1);
+    m_root.resize(n);
+    m_cluster_of_root.resize(n);
+    m_labels.resize(n);
+    m_counts.resize(k);
+    m_centers.resize(k, d);
+  }
+
+  // Prim's algorithm: grow the tree from row 0, always adding the closest
+  // row outside of it. Squared distances give the same tree.
+  bool build_tree(const double* data, int n, int d, std::stop_token stop)
+  {
+    std::fill(m_min_dist.begin(), m_min_dist.end(), std::numeric_limits<double>::max());
+    std::fill(m_in_tree.begin(), m_in_tree.end(), char(0));
+
+    int current = 0;
+    m_in_tree[0] = 1;
+    for (int step = 0; step < n - 1; ++step) {
+      if (stop.stop_requested()) {
+        return false;
+      }
+      const double* x = data + std::size_t(current) * d;
+      int next = -1;
+      double next_dist = std::numeric_limits<double>::max();
+      for (int i = 0; i < n; ++i) {
+        if (m_in_tree[i]) {
+          continue;
+        }
+        const double* y = data + std::size_t(i) * d;
+        double dist = 0.0;
+        for (int c = 0; c < d; ++c) {
+          const double diff = x[c] - y[c];
+          dist += diff * diff;
+        }
+        if (dist < m_min_dist[i]) {
+          m_min_dist[i] = dist;
+          m_parent[i] = current;
+        }
+        if (next < 0 || m_min_dist[i] < next_dist) {
+          next_dist = m_min_dist[i];
+          next = i;
+        }
+      }
+      m_in_tree[next] = 1;
+      m_edges[step] = {next_dist, next, m_parent[next]};
+      current = next;
+    }
+    return true;
+  }
+
+  int find(int i)
+  {
+    while (m_root[i] != i) {
+      m_root[i] = m_root[m_root[i]];
+      i = m_root[i];
+    }
+    return i;
+  }
+
+  std::vector<double> m_min_dist;
+  std::vector<int> m_parent;
+  std::vector<char> m_in_tree;
+  std::vector<Edge> m_edges;
+  std::vector<int> m_root;
+  std::vector<int> m_cluster_of_root;
+  std::vector<int> m_labels;
+  std::vector<int> m_counts;
+  RowMajorMatrix m_centers;
+};
+
+
+// Mini-batch k-means on a stream (Sculley, "Web-scale k-means clustering").
+// Each batch is labelled with the current centers, then every row pulls its
+// center towards it with a per-center rate of 1 / (rows seen by that center),
+// so each center is the running mean of its rows. Only the k x d centers and
+// the k counts are kept: the cost of a batch only depends on its size.
+// The centers are seeded with k-means++ over the first batch; a first batch
+// of fewer than k rows makes each row a center until k rows have been seen.
+// A stream rarely shows every cluster in its first batch, so the seeds can
+// all fall in one cluster. When a row lies farther from every center than
+// the two closest centers are from each other, those two are merged and the
+// freed center restarts at that row: clusters that appear later in the
+// stream get a center of their own instead of dragging an existing one.
+class OnlineKMeans
+{
+public:
+  using RowMajorMatrix = KMeans::RowMajorMatrix;
+
+  void reset()
+  {
+    m_filled = 0;
+    m_k = 0;
+    m_d = 0;
+  }
+
+  // Label a batch of n rows and update the centers with it. A new number of
+  // clusters or features restarts the stream, seeded from `seed`.
+  // Returns false on invalid input.
+  bool partial_fit(const double* data, int n, int d, int k, unsigned seed = 0)
+  {
+    if (!data || n <= 0 || d <= 0 || k <= 0) {
+      return false;
+    }
+    if (k != m_k || d != m_d) {
+      m_k = k;
+      m_d = d;
+      m_filled = 0;
+      m_centers.resize(k, d);
+      m_counts.assign(k, 0.0);
+      m_rng.seed(seed);
+    }
+    m_labels.resize(n);
+    m_min_dist.resize(n);
+
+    // Assignment with the centers as they were before this batch
+    int first_unlabelled = 0;
+    if (m_filled == 0 && n >= k) {
+      KMeans::seed_plus_plus(data, n, d, k, m_rng, m_min_dist, m_centers);
+      std::fill(m_counts.begin(), m_counts.end(), 0.0);
+      m_filled = k;
+    }
+    while (m_filled < k && first_unlabelled < n) {
+      // Still seeding: the row becomes a center of its own
+      const int j = m_filled++;
+      std::copy_n(data + std::size_t(first_unlabelled) * d, d, &m_centers(j, 0));
+      m_counts[j] = 1.0;
+      m_labels[first_unlabelled++] = j;
+    }
+    label(data, first_unlabelled, n);
+    if (m_filled == k) {
+      // Each pass frees one center, at most k - 1 can move
+      for (int pass = 1; pass < k && reseed(data, first_unlabelled, n); ++pass) {
+        label(data, first_unlabelled, n);
+      }
+    }
+
+    // Gradient step per row
+    for (int i = first_unlabelled; i < n; ++i) {
+      const int j = m_labels[i];
+      m_counts[j] += 1.0;
+      const double eta = 1.0 / m_counts[j];
+      const double* row = data + std::size_t(i) * d;
+      double* center = &m_centers(j, 0);
+      for (int c = 0; c < d; ++c) {
+        center[c] += eta * (row[c] - center[c]);
+      }
+    }
+    return true;
+  }
+
+  // Cluster index of every row of the last batch
+  const std::vector<int>& labels() const { return m_labels; }
+
+  // Centers found so far (fewer than k rows until k rows have been seen)
+  auto centers() const { return m_centers.topRows(m_filled); }
+
+private:
+  double sq_dist(const double* a, const double* b) const
+  {
+    double dist = 0.0;
+    for (int c = 0; c < m_d; ++c) {
+      const double diff = a[c] - b[c];
+      dist += diff * diff;
+    }
+    return dist;
+  }
+
+  // Nearest center and its squared distance for rows [begin, end)
+  void label(const double* data, int begin, int end)
+  {
+    for (int i = begin; i < end; ++i) {
+      const double* x = data + std::size_t(i) * m_d;
+      int best = 0;
+      double best_dist = std::numeric_limits<double>::max();
+      for (int j = 0; j < m_filled; ++j) {
+        const double dist = sq_dist(x, &m_centers(j, 0));
+        if (dist < best_dist) {
+          best_dist = dist;
+          best = j;
+        }
+      }
+      m_labels[i] = best;
+      m_min_dist[i] = best_dist;
+    }
+  }
+
+  // Merge the two closest centers and restart the freed one at the row
+  // farthest from its center, if that row is farther than the two centers
+  // are apart. Returns false when no center was moved.
+  bool reseed(const double* data, int begin, int end)
+  {
+    int far = -1;
+    double far_dist = 0.0;
+    for (int i = begin; i < end; ++i) {
+      if (m_min_dist[i] > far_dist) {
+        far_dist = m_min_dist[i];
+        far = i;
+      }
+    }
+    if (far < 0) {
+      return false;
+    }
+
+    int p = 0, q = 1;
+    double pair_dist = std::numeric_limits<double>::max();
+    for (int a = 0; a < m_k; ++a) {
+      for (int b = a + 1; b < m_k; ++b) {
+        const double dist = sq_dist(&m_centers(a, 0), &m_centers(b, 0));
+        if (dist < pair_dist) {
+          pair_dist = dist;
+          p = a;
+          q = b;
+        }
+      }
+    }
+    if (far_dist <= pair_dist) {
+      return false;
+    }
+
+    const double total = m_counts[p] + m_counts[q];
+    if (total > 0.0) {
+      m_centers.row(p)
+          = (m_counts[p] * m_centers.row(p) + m_counts[q] * m_centers.row(q)) / total;
+    }
+    m_counts[p] = total;
+    std::copy_n(data + std::size_t(far) * m_d, m_d, &m_centers(q, 0));
+    m_counts[q] = 0.0;
+    return true;
+  }
+
+  RowMajorMatrix m_centers;
+  std::vector<double> m_counts;
+  std::vector<int> m_labels;
+  std::vector<double> m_min_dist;
+  std::mt19937 m_rng;
+  int m_filled{0};
+  int m_k{0};
+  int m_d{0};
+};
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace puara_gestures::algorithms
+{
+// Leading eigenpairs of a symmetric matrix by subspace iteration with
+// Rayleigh-Ritz, for when only k of its n eigenvectors are needed.
+// Each iteration costs one n x n by n x b product plus a QR of the n x b
+// basis (b = k plus a few extra vectors to speed up convergence), instead of
+// the O(n³) full decomposition. The basis is kept between calls: a matrix that
+// changed little since the last compute() converges in a few iterations, and
+// one whose leading eigenvalues are too close to separate within
+// max_iterations keeps being refined by the following calls.
+class TopEigenSolver
+{
+public:
+  // Returns false if k is out of range. Otherwise eigenvectors() holds the
+  // current estimate, and converged() tells whether every residual
+  // |A v - λ v| fell below tolerance * λ_max.
+  bool compute(
+      const Eigen::MatrixXd& a, int k, int max_iterations = 30,
+      double tolerance = 1e-6)
+  {
+    const int n = int(a.rows());
+    if (k <= 0 || k > n || a.cols() != n) {
+      return false;
+    }
+    const int block = std::min(n, k + std::min(k, 8));
+
+    if (m_basis.rows() != n || m_basis.cols() != block) {
+      // Cold start from a fixed pseudo-random basis
+      std::mt19937 gen(0);
+      std::normal_distribution<double> normal;
+      m_basis.resize(n, block);
+      for (Eigen::Index i = 0; i < m_basis.size(); ++i) {
+        m_basis.data()[i] = normal(gen);
+      }
+    }
+    orthonormalize();
+
+    m_converged = false;
+    for (int iter = 0; iter < max_iterations && !m_converged; ++iter) {
+      // Rayleigh-Ritz on the current basis
+      m_product.noalias() = a * m_basis;
+      m_projected.noalias() = m_basis.transpose() * m_product;
+      m_small_solver.compute(m_projected);
+      if (m_small_solver.info() != Eigen::Success) {
+        return false;
+      }
+      m_rotation = m_small_solver.eigenvectors().rowwise().reverse();
+      m_values = m_small_solver.eigenvalues().reverse();
+
+      m_ritz.noalias() = m_basis * m_rotation;
+      m_product_ritz.noalias() = m_product * m_rotation;
+
+      // Converged when |A v - θ v| is small for the k leading Ritz pairs
+      const double scale = std::max(std::abs(m_values[0]), 1e-300);
+      m_converged = true;
+      for (int i = 0; i < k; ++i) {
+        const double residual
+            = (m_product_ritz.col(i) - m_values[i] * m_ritz.col(i)).norm();
+        if (residual > tolerance * scale) {
+          m_converged = false;
+          break;
+        }
+      }
+
+      // A times the Ritz vectors is the next (un-normalized) basis
+      if (!m_converged && iter + 1 < max_iterations) {
+        m_basis = m_product_ritz;
+        orthonormalize();
+      }
+    }
+
+    // The Ritz vectors are the warm start of the next call
+    m_basis = m_ritz;
+    m_vectors = m_ritz.leftCols(k);
+    return true;
+  }
+
+  bool converged() const { return m_converged; }
+
+  // n x k, leading eigenvector first
+  const Eigen::MatrixXd& eigenvectors() const { return m_vectors; }
+
+  // Leading eigenvalues, descending (at least k of them)
+  const Eigen::VectorXd& eigenvalues() const { return m_values; }
+
+  // Forget the warm-start basis
+  void reset() { m_basis.resize(0, 0); }
+
+private:
+  void orthonormalize()
+  {
+    m_qr.compute(m_basis);
+    m_basis.setIdentity();
+    m_basis = m_qr.householderQ() * m_basis;
+  }
+
+  Eigen::MatrixXd m_basis;
+  Eigen::MatrixXd m_product;
+  Eigen::MatrixXd m_projected;
+  Eigen::MatrixXd m_rotation;
+  Eigen::MatrixXd m_ritz;
+  Eigen::MatrixXd m_product_ritz;
+  Eigen::MatrixXd m_vectors;
+  Eigen::VectorXd m_values;
+  Eigen::HouseholderQR<Eigen::MatrixXd> m_qr;
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> m_small_solver;
+  bool m_converged{false};
+};
+
+}
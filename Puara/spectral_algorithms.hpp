@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+namespace puara_gestures::algorithms
+{
+// Forward FFT of a real signal of power-of-two size n (n >= 4). The input is
+// packed as n/2 complex samples, transformed with an iterative radix-2 FFT and
+// split into the n/2 + 1 non-redundant bins. Twiddles and the bit-reversal
+// permutation are computed in resize(); transform() does not allocate.
+class RealFFT
+{
+public:
+  void resize(std::size_t n)
+  {
+    if (n == m_n) {
+      return;
+    }
+    m_n = n;
+    const std::size_t m = n / 2;
+
+    m_twiddle.resize(m / 2);
+    for (std::size_t j = 0; j < m / 2; ++j) {
+      m_twiddle[j] = std::polar(1.0, -2.0 * std::numbers::pi * double(j) / double(m));
+    }
+
+    m_split.resize(m + 1);
+    for (std::size_t k = 0; k <= m; ++k) {
+      m_split[k] = std::polar(1.0, -2.0 * std::numbers::pi * double(k) / double(n));
+    }
+
+    m_bitrev.resize(m);
+    std::size_t bits = 0;
+    while ((std::size_t(1) << bits) < m) {
+      ++bits;
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+      std::size_t r = 0;
+      for (std::size_t b = 0; b < bits; ++b) {
+        r |= ((i >> b) & 1) << (bits - 1 - b);
+      }
+      m_bitrev[i] = r;
+    }
+
+    m_work.resize(m);
+  }
+
+  std::size_t size() const { return m_n; }
+  std::size_t bins() const { return m_n / 2 + 1; }
+
+  // in: size() real samples, out: bins() complex values
+  void transform(const double* in, std::complex<double>* out)
+  {
+    const std::size_t m = m_n / 2;
+    auto* z = m_work.data();
+
+    for (std::size_t i = 0; i < m; ++i) {
+      const std::size_t r = m_bitrev[i];
+      z[r] = {in[2 * i], in[2 * i + 1]};
+    }
+
+    for (std::size_t len = 2; len <= m; len <<= 1) {
+      const std::size_t half = len / 2;
+      const std::size_t stride = m / len;
+      for (std::size_t start = 0; start < m; start += len) {
+        for (std::size_t j = 0; j < half; ++j) {
+          const auto t = m_twiddle[j * stride] * z[start + j + half];
+          z[start + j + half] = z[start + j] - t;
+          z[start + j] += t;
+        }
+      }
+    }
+
+    // X[k] = E[k] + W^k O[k], with E/O recovered from Z[k] and conj(Z[m-k])
+    for (std::size_t k = 0; k <= m; ++k) {
+      const auto zk = z[k == m ? 0 : k];
+      const auto zc = std::conj(z[k == 0 ? 0 : m - k]);
+      const auto even = 0.5 * (zk + zc);
+      const auto odd = std::complex<double>(0.0, -0.5) * (zk - zc);
+      out[k] = even + m_split[k] * odd;
+    }
+  }
+
+private:
+  std::size_t m_n{0};
+  std::vector<std::complex<double>> m_twiddle;
+  std::vector<std::complex<double>> m_split;
+  std::vector<std::size_t> m_bitrev;
+  std::vector<std::complex<double>> m_work;
+};
+
+enum class SpectralWindow { Hann, Hamming, Blackman, Rectangular };
+
+// Periodic window of size n, as used for spectral estimation
+inline void make_window(SpectralWindow type, std::vector<double>& w, std::size_t n)
+{
+  w.resize(n);
+  const double step = 2.0 * std::numbers::pi / double(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double x = step * double(i);
+    switch (type) {
+      case SpectralWindow::Hann:
+        w[i] = 0.5 - 0.5 * std::cos(x);
+        break;
+      case SpectralWindow::Hamming:
+        w[i] = 0.54 - 0.46 * std::cos(x);
+        break;
+      case SpectralWindow::Blackman:
+        w[i] = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+        break;
+      case SpectralWindow::Rectangular:
+        w[i] = 1.0;
+        break;
+    }
+  }
+}
+
+// Streaming Welch estimate of a one-sided power spectral density (V²/Hz,
+// same scaling as scipy.signal.welch with detrend='constant'). Samples are
+// pushed as they arrive; every `hop` samples the last `segment` samples are
+// windowed, transformed and their periodogram replaces the oldest of the
+// `averages` stored ones. The estimate is the mean of the stored periodograms.
+// All buffers are sized in configure(); push() does not allocate.
+class WelchPSD
+{
+public:
+  // segment must be a power of two >= 4
+  void configure(
+      std::size_t segment, std::size_t hop, std::size_t averages, SpectralWindow window,
+      double sample_rate, bool remove_mean)
+  {
+    m_fft.resize(segment);
+    make_window(window, m_window, segment);
+
+    m_hop = std::clamp<std::size_t>(hop, 1, segment);
+    m_averages = std::max<std::size_t>(averages, 1);
+    m_remove_mean = remove_mean;
+
+    double w2 = 0.0;
+    for (double w : m_window) {
+      w2 += w * w;
+    }
+    m_scale = sample_rate > 0.0 && w2 > 0.0 ? 1.0 / (sample_rate * w2) : 0.0;
+
+    const std::size_t bins = m_fft.bins();
+    m_ring.assign(segment, 0.0);
+    m_frame.resize(segment);
+    m_spectrum.resize(bins);
+    m_periodograms.assign(m_averages * bins, 0.0);
+    m_psd.assign(bins, 0.0);
+
+    m_frequencies.resize(bins);
+    for (std::size_t k = 0; k < bins; ++k) {
+      m_frequencies[k] = double(k) * sample_rate / double(segment);
+    }
+
+    reset();
+  }
+
+  void reset()
+  {
+    std::fill(m_ring.begin(), m_ring.end(), 0.0);
+    std::fill(m_psd.begin(), m_psd.end(), 0.0);
+    m_write = 0;
+    m_filled = 0;
+    m_since_last = 0;
+    m_stored = 0;
+    m_slot = 0;
+  }
+
+  // Returns true when at least one new segment was added to the estimate
+  bool push(const double* x, std::size_t count)
+  {
+    const std::size_t n = m_ring.size();
+    if (n == 0) {
+      return false;
+    }
+
+    bool updated = false;
+    for (std::size_t i = 0; i < count; ++i) {
+      m_ring[m_write] = x[i];
+      if (++m_write == n) {
+        m_write = 0;
+      }
+      if (m_filled < n) {
+        ++m_filled;
+      }
+      if (++m_since_last >= m_hop && m_filled == n) {
+        m_since_last = 0;
+        add_segment();
+        updated = true;
+      }
+    }
+
+    if (updated) {
+      average();
+    }
+    return updated;
+  }
+
+  const std::vector<double>& psd() const { return m_psd; }
+  const std::vector<double>& frequencies() const { return m_frequencies; }
+  std::size_t segments() const { return m_stored; }
+
+private:
+  void add_segment()
+  {
+    const std::size_t n = m_ring.size();
+
+    // Unroll the ring so the oldest sample comes first
+    std::copy(m_ring.begin() + m_write, m_ring.end(), m_frame.begin());
+    std::copy(m_ring.begin(), m_ring.begin() + m_write, m_frame.begin() + (n - m_write));
+
+    double mean = 0.0;
+    if (m_remove_mean) {
+      for (double v : m_frame) {
+        mean += v;
+      }
+      mean /= double(n);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      m_frame[i] = (m_frame[i] - mean) * m_window[i];
+    }
+
+    m_fft.transform(m_frame.data(), m_spectrum.data());
+
+    // One-sided: every bin but DC and Nyquist carries the negative frequencies too
+    const std::size_t bins = m_spectrum.size();
+    double* p = m_periodograms.data() + m_slot * bins;
+    for (std::size_t k = 0; k < bins; ++k) {
+      const double scale = (k == 0 || k == bins - 1) ? m_scale : 2.0 * m_scale;
+      p[k] = std::norm(m_spectrum[k]) * scale;
+    }
+
+    if (++m_slot == m_averages) {
+      m_slot = 0;
+    }
+    if (m_stored < m_averages) {
+      ++m_stored;
+    }
+  }
+
+  void average()
+  {
+    const std::size_t bins = m_psd.size();
+    std::fill(m_psd.begin(), m_psd.end(), 0.0);
+    for (std::size_t s = 0; s < m_stored; ++s) {
+      const double* p = m_periodograms.data() + s * bins;
+      for (std::size_t k = 0; k < bins; ++k) {
+        m_psd[k] += p[k];
+      }
+    }
+    const double inv = 1.0 / double(m_stored);
+    for (double& v : m_psd) {
+      v *= inv;
+    }
+  }
+
+  RealFFT m_fft;
+  std::vector<double> m_window;
+  std::vector<double> m_ring;
+  std::vector<double> m_frame;
+  std::vector<std::complex<double>> m_spectrum;
+  std::vector<double> m_periodograms;
+  std::vector<double> m_psd;
+  std::vector<double> m_frequencies;
+
+  std::size_t m_hop{1};
+  std::size_t m_averages{1};
+  std::size_t m_write{0};
+  std::size_t m_filled{0};
+  std::size_t m_since_last{0};
+  std::size_t m_stored{0};
+  std::size_t m_slot{0};
+  double m_scale{0.0};
+  bool m_remove_mean{true};
+};
+
+}
@@ -3,49 +3,202 @@
 #include <xtensor/containers/xarray.hpp>
 #include <xtensor/core/xmath.hpp>
 #include <boost/math/distributions/students_t.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <utility>
+#include <vector>
 
 namespace puara_gestures::algorithms
 {
-inline std::pair<double, double> calculate_pearson(const xt::xarray<double>& x, const xt::xarray<double>& y)
+// Two-sided p-value of a Pearson r over n samples (Student t with n - 2 dof)
+inline double pearson_p_value(double r, std::size_t n)
+{
+  const double r_clamped = std::max(-1.0, std::min(1.0, r));
+
+  if (std::abs(r_clamped) == 1.0) {
+    return 0.0;
+  }
+  const double t_stat = r_clamped * std::sqrt((n - 2.0) / (1.0 - r_clamped * r_clamped));
+
+  boost::math::students_t dist(n - 2.0);
+  return boost::math::cdf(boost::math::complement(dist, std::abs(t_stat))) * 2.0;
+}
+
+// Pearson r and p-value of two arrays of n samples, two passes and no temporaries
+inline std::pair<double, double> calculate_pearson(const double* x, const double* y, std::size_t n)
 {
-  const size_t n = x.size();
   if (n < 3) {
-    
     return {0.0, 1.0};
   }
 
-  
-  const double mean_x = xt::mean(x)();
-  const double mean_y = xt::mean(y)();
+  double mean_x = 0.0, mean_y = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    mean_x += x[i];
+    mean_y += y[i];
+  }
+  mean_x /= n;
+  mean_y /= n;
 
-  const double cov_xy = xt::mean((x - mean_x) * (y - mean_y))();
-  const double stddev_x = xt::stddev(x)();
-  const double stddev_y = xt::stddev(y)();
+  double cxy = 0.0, m2x = 0.0, m2y = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const double dx = x[i] - mean_x;
+    const double dy = y[i] - mean_y;
+    cxy += dx * dy;
+    m2x += dx * dx;
+    m2y += dy * dy;
+  }
 
-  if (stddev_x == 0.0 || stddev_y == 0.0) {
-    
+  if (m2x == 0.0 || m2y == 0.0) {
     return {0.0, 1.0};
   }
-  const double r = cov_xy / (stddev_x * stddev_y);
+  const double r = cxy / std::sqrt(m2x * m2y);
+  return {r, pearson_p_value(r, n)};
+}
 
-  const double r_clamped = std::max(-1.0, std::min(1.0, r));
+inline std::pair<double, double> calculate_pearson(const xt::xarray<double>& x, const xt::xarray<double>& y)
+{
+  return calculate_pearson(x.data(), y.data(), x.size());
+}
 
-  
-  if (std::abs(r_clamped) == 1.0) {
-    return {r_clamped, 0.0};
+// Pearson correlation over a sliding window of the last N (x, y) pairs.
+// Means and co-moments are maintained with Welford add / remove updates, so a
+// new pair costs O(1) whatever the window size. They are recomputed exactly
+// from the window once per N pushes, which bounds rounding drift at an
+// amortized O(1) cost.
+class SlidingPearson
+{
+public:
+  // Sets the window length and clears the history
+  void resize(std::size_t window)
+  {
+    m_x.assign(std::max<std::size_t>(window, 1), 0.0);
+    m_y.assign(m_x.size(), 0.0);
+    reset();
   }
-  const double t_stat = r_clamped * std::sqrt((n - 2.0) / (1.0 - r_clamped * r_clamped));
 
-  boost::math::students_t dist(n - 2.0);
-  double p = boost::math::cdf(boost::math::complement(dist, std::abs(t_stat))) * 2.0;
+  void reset()
+  {
+    m_head = 0;
+    m_size = 0;
+    m_pushes = 0;
+    m_mean_x = m_mean_y = 0.0;
+    m_m2x = m_m2y = m_cxy = 0.0;
+  }
+
+  std::size_t capacity() const { return m_x.size(); }
+  std::size_t size() const { return m_size; }
+
+  void push(double x, double y)
+  {
+    if (m_x.empty())
+      resize(1);
+
+    const std::size_t cap = m_x.size();
+    const std::size_t tail = (m_head + m_size) % cap;
+    if (m_size == cap) {
+      remove(m_x[m_head], m_y[m_head]);
+      m_head = (m_head + 1) % cap;
+    }
+    m_x[tail] = x;
+    m_y[tail] = y;
+    add(x, y);
+
+    if (++m_pushes >= cap) {
+      resync();
+      m_pushes = 0;
+    }
+  }
+
+  void push(const double* x, const double* y, std::size_t n)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      push(x[i], y[i]);
+  }
+
+  // {r, p} over the current window content
+  std::pair<double, double> result() const
+  {
+    if (m_size < 3 || !(m_m2x > 0.0) || !(m_m2y > 0.0)) {
+      return {0.0, 1.0};
+    }
+    const double r = m_cxy / std::sqrt(m_m2x * m_m2y);
+    return {r, pearson_p_value(r, m_size)};
+  }
+
+private:
+  // Welford update; the co-moment uses the x deviation from the old mean and
+  // the y deviation from the new one
+  void add(double x, double y)
+  {
+    ++m_size;
+    const double dx = x - m_mean_x;
+    const double dy = y - m_mean_y;
+    m_mean_x += dx / m_size;
+    m_mean_y += dy / m_size;
+    m_m2x += dx * (x - m_mean_x);
+    m_m2y += dy * (y - m_mean_y);
+    m_cxy += dx * (y - m_mean_y);
+  }
+
+  // exact inverse of add()
+  void remove(double x, double y)
+  {
+    if (m_size <= 1) {
+      reset();
+      return;
+    }
+    --m_size;
+    const double dx = x - m_mean_x;
+    const double dy = y - m_mean_y;
+    m_mean_x -= dx / m_size;
+    m_mean_y -= dy / m_size;
+    m_m2x -= (x - m_mean_x) * dx;
+    m_m2y -= (y - m_mean_y) * dy;
+    m_cxy -= (x - m_mean_x) * dy;
+  }
+
+  void resync()
+  {
+    const std::size_t cap = m_x.size();
+    double mean_x = 0.0, mean_y = 0.0;
+    for (std::size_t i = 0; i < m_size; ++i) {
+      mean_x += m_x[(m_head + i) % cap];
+      mean_y += m_y[(m_head + i) % cap];
+    }
+    mean_x /= m_size;
+    mean_y /= m_size;
+
+    double cxy = 0.0, m2x = 0.0, m2y = 0.0;
+    for (std::size_t i = 0; i < m_size; ++i) {
+      const double dx = m_x[(m_head + i) % cap] - mean_x;
+      const double dy = m_y[(m_head + i) % cap] - mean_y;
+      cxy += dx * dy;
+      m2x += dx * dx;
+      m2y += dy * dy;
+    }
+    m_mean_x = mean_x;
+    m_mean_y = mean_y;
+    m_cxy = cxy;
+    m_m2x = m2x;
+    m_m2y = m2y;
+  }
+
+  std::vector<double> m_x, m_y;
+  std::size_t m_head{0};
+  std::size_t m_size{0};
+  std::size_t m_pushes{0};
+  double m_mean_x{0.0}, m_mean_y{0.0};
+  double m_m2x{0.0}, m_m2y{0.0}, m_cxy{0.0};
+};
 
-  return {r, p};
 }
 
 }
 
 #include <xtensor/views/xview.hpp>
+#include <span>
 #include <vector>
 
 namespace puara_gestures::algorithms
@@ -86,4 +239,112 @@ inline double calculate_power_in_band(
   return band_power;
 }
 
+struct FrequencyBand
+{
+  double f_min;
+  double f_max;
+};
+
+// Power in a set of frequency bands of a PSD, without allocating per call.
+// The [begin, end) index range of every band is cached and only rebuilt when
+// the frequency vector or the bands change (the frequencies normally come
+// from an FFT upstream and are identical from one tick to the next). All the
+// bands and the total are then obtained from a single pass over the PSD, by
+// sampling its running sum at the band edges.
+class BandPowerPlan
+{
+public:
+  void update(std::span<const double> freqs, std::span<const FrequencyBand> bands)
+  {
+    const bool same_freqs = std::equal(freqs.begin(), freqs.end(), m_freqs.begin(), m_freqs.end());
+    const bool same_bands = std::equal(
+        bands.begin(), bands.end(), m_bands.begin(), m_bands.end(),
+        [](const FrequencyBand& a, const FrequencyBand& b) {
+          return a.f_min == b.f_min && a.f_max == b.f_max;
+        });
+    if (same_freqs && same_bands)
+      return;
+
+    m_freqs.assign(freqs.begin(), freqs.end());
+    m_bands.assign(bands.begin(), bands.end());
+    m_sorted = std::is_sorted(m_freqs.begin(), m_freqs.end());
+    m_band_cuts.assign(bands.size(), {0, 0});
+    m_cuts.clear();
+    m_cuts.push_back(m_freqs.size());
+
+    if (!m_sorted)
+      return;
+
+    // Inclusive bands: f_min <= f <= f_max
+    std::vector<std::pair<std::size_t, std::size_t>> ranges(bands.size());
+    for (std::size_t b = 0; b < bands.size(); ++b)
+    {
+      auto first = std::lower_bound(m_freqs.begin(), m_freqs.end(), bands[b].f_min);
+      auto last = std::upper_bound(first, m_freqs.end(), bands[b].f_max);
+      ranges[b] = {std::size_t(first - m_freqs.begin()), std::size_t(last - m_freqs.begin())};
+      m_cuts.push_back(ranges[b].first);
+      m_cuts.push_back(ranges[b].second);
+    }
+    std::sort(m_cuts.begin(), m_cuts.end());
+    m_cuts.erase(std::unique(m_cuts.begin(), m_cuts.end()), m_cuts.end());
+    m_prefix.assign(m_cuts.size(), 0.0);
+
+    auto cut_of = [this](std::size_t index) {
+      return std::size_t(std::lower_bound(m_cuts.begin(), m_cuts.end(), index) - m_cuts.begin());
+    };
+    for (std::size_t b = 0; b < bands.size(); ++b)
+      m_band_cuts[b] = {cut_of(ranges[b].first), cut_of(ranges[b].second)};
+  }
+
+  // psd must have as many points as the frequency vector given to update().
+  // Writes the power of each band (relative to the total if requested).
+  void compute(const double* psd, std::span<double> band_power, PowerBandType power_type)
+  {
+    const std::size_t n = m_freqs.size();
+    double total = 0.0;
+
+    if (m_sorted)
+    {
+      std::size_t i = 0;
+      for (std::size_t c = 0; c < m_cuts.size(); ++c)
+      {
+        for (; i < m_cuts[c]; ++i)
+          total += psd[i];
+        m_prefix[c] = total;
+      }
+      for (std::size_t b = 0; b < m_band_cuts.size(); ++b)
+        band_power[b] = m_prefix[m_band_cuts[b].second] - m_prefix[m_band_cuts[b].first];
+    }
+    else
+    {
+      // Arbitrary frequency order: test every point against every band
+      std::fill(band_power.begin(), band_power.end(), 0.0);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        total += psd[i];
+        for (std::size_t b = 0; b < m_bands.size(); ++b)
+          if (m_freqs[i] >= m_bands[b].f_min && m_freqs[i] <= m_bands[b].f_max)
+            band_power[b] += psd[i];
+      }
+    }
+
+    if (power_type == PowerBandType::Relative)
+    {
+      for (double& p : band_power)
+        p = (total > 0) ? (p / total) : 0.0;
+    }
+  }
+
+private:
+  std::vector<double> m_freqs;
+  std::vector<FrequencyBand> m_bands;
+  bool m_sorted{false};
+
+  // Sorted unique band edges (indices into the PSD, including its size),
+  // the PSD running sum at each of them, and each band's pair of edges
+  std::vector<std::size_t> m_cuts;
+  std::vector<double> m_prefix;
+  std::vector<std::pair<std::size_t, std::size_t>> m_band_cuts;
+};
+
 }
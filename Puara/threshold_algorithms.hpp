@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace puara_gestures::algorithms
+{
+enum class ThresholdType
+{
+  Both,
+  Above,
+  Below
+};
+
+// Calls f with the comparison selected by `type`, so that the loops over
+// samples are compiled once per comparison instead of branching per sample
+template <typename T, typename F>
+decltype(auto) with_threshold(ThresholdType type, T threshold, F&& f)
+{
+  switch (type) {
+    case ThresholdType::Above:
+      return f([threshold](auto x) { return x > threshold; });
+    case ThresholdType::Below:
+      return f([threshold](auto x) { return x < threshold; });
+    case ThresholdType::Both:
+    default:
+      return f([threshold](auto x) { return std::abs(x) > threshold; });
+  }
+}
+
+namespace detail
+{
+#if defined(__SSE2__)
+// One SSE2 register of T: compare, then movemask the lanes straight into bits
+template <typename T>
+struct ThresholdLanes;
+
+template <>
+struct ThresholdLanes<double>
+{
+  static constexpr int size = 2;
+  static __m128d load(const double* p) { return _mm_loadu_pd(p); }
+  static __m128d set1(double v) { return _mm_set1_pd(v); }
+  static __m128d abs(__m128d v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+  static __m128d greater(__m128d a, __m128d b) { return _mm_cmpgt_pd(a, b); }
+  static int mask(__m128d m) { return _mm_movemask_pd(m); }
+};
+
+template <>
+struct ThresholdLanes<float>
+{
+  static constexpr int size = 4;
+  static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+  static __m128 set1(float v) { return _mm_set1_ps(v); }
+  static __m128 abs(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+  static __m128 greater(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+  static int mask(__m128 m) { return _mm_movemask_ps(m); }
+};
+
+template <ThresholdType Type, typename T>
+std::uint64_t threshold_word(const T* x, T threshold)
+{
+  using L = ThresholdLanes<T>;
+  const auto t = L::set1(threshold);
+  auto lanes = [t](const T* p) {
+    const auto v = L::load(p);
+    if constexpr (Type == ThresholdType::Above)
+      return unsigned(L::mask(L::greater(v, t)));
+    else if constexpr (Type == ThresholdType::Below)
+      return unsigned(L::mask(L::greater(t, v)));
+    else
+      return unsigned(L::mask(L::greater(L::abs(v), t)));
+  };
+
+  // Whole bytes at a time, so that the shifts within a byte are constants
+  std::uint64_t word = 0;
+  for (int j = 0; j < 64; j += 8) {
+    unsigned byte;
+    if constexpr (L::size == 4)
+      byte = lanes(x + j) | lanes(x + j + 4) << 4;
+    else
+      byte = lanes(x + j) | lanes(x + j + 2) << 2 | lanes(x + j + 4) << 4
+             | lanes(x + j + 6) << 6;
+    word |= std::uint64_t(byte) << j;
+  }
+  return word;
+}
+#else
+// Portable path: one 0/1 byte per sample, then the low bits of 8 bytes are
+// gathered into one byte with a multiplication (little-endian targets)
+template <ThresholdType Type, typename T>
+std::uint64_t threshold_word(const T* x, T threshold)
+{
+  std::uint8_t bytes[64];
+  for (int j = 0; j < 64; ++j) {
+    if constexpr (Type == ThresholdType::Above)
+      bytes[j] = x[j] > threshold;
+    else if constexpr (Type == ThresholdType::Below)
+      bytes[j] = x[j] < threshold;
+    else
+      bytes[j] = std::abs(x[j]) > threshold;
+  }
+  std::uint64_t word = 0;
+  for (int k = 0; k < 8; ++k) {
+    std::uint64_t v;
+    std::memcpy(&v, bytes + 8 * k, 8);
+    word |= ((v * 0x0102040810204080ull) >> 56) << (8 * k);
+  }
+  return word;
+}
+#endif
+
+template <ThresholdType Type, typename T>
+void threshold_bits(const T* in, std::size_t n, T threshold, std::uint64_t* bits)
+{
+  const std::size_t full = n / 64;
+  for (std::size_t w = 0; w < full; ++w) {
+    bits[w] = threshold_word<Type>(in + 64 * w, threshold);
+  }
+
+  if (const std::size_t rest = n % 64) {
+    std::uint64_t word = 0;
+    with_threshold(Type, threshold, [&](auto crosses) {
+      for (std::size_t j = 0; j < rest; ++j)
+        word |= std::uint64_t(crosses(in[64 * full + j])) << j;
+    });
+    bits[full] = word;
+  }
+}
+
+template <ThresholdType Type, typename T>
+void threshold_bytes(const T* in, std::size_t n, T threshold, std::uint8_t* bytes)
+{
+  const std::size_t full = n / 64;
+  for (std::size_t w = 0; w < full; ++w) {
+    const std::uint64_t word = threshold_word<Type>(in + 64 * w, threshold);
+    // Spread each group of 8 bits over 8 bytes (little-endian targets)
+    for (int k = 0; k < 8; ++k) {
+      std::uint64_t v = (word >> (8 * k)) & 0xff;
+      v = (v | v << 28) & 0x0000000F0000000Full;
+      v = (v | v << 14) & 0x0003000300030003ull;
+      v = (v | v << 7) & 0x0101010101010101ull;
+      std::memcpy(bytes + 64 * w + 8 * k, &v, 8);
+    }
+  }
+
+  with_threshold(Type, threshold, [&](auto crosses) {
+    for (std::size_t i = 64 * full; i < n; ++i)
+      bytes[i] = crosses(in[i]);
+  });
+}
+}
+
+// Packs the comparison of each of the n samples into bits: bit i % 64 of
+// bits[i / 64] is set when in[i] crosses the threshold. bits must hold
+// (n + 63) / 64 words; the unused high bits of the last one are cleared.
+template <typename T>
+void threshold_bits(
+    const T* in, std::size_t n, ThresholdType type, T threshold, std::uint64_t* bits)
+{
+  switch (type) {
+    case ThresholdType::Above:
+      return detail::threshold_bits<ThresholdType::Above>(in, n, threshold, bits);
+    case ThresholdType::Below:
+      return detail::threshold_bits<ThresholdType::Below>(in, n, threshold, bits);
+    case ThresholdType::Both:
+    default:
+      return detail::threshold_bits<ThresholdType::Both>(in, n, threshold, bits);
+  }
+}
+
+// One byte per sample, 1 where in[i] crosses the threshold and 0 elsewhere
+template <typename T>
+void threshold_bytes(
+    const T* in, std::size_t n, ThresholdType type, T threshold, std::uint8_t* bytes)
+{
+  switch (type) {
+    case ThresholdType::Above:
+      return detail::threshold_bytes<ThresholdType::Above>(in, n, threshold, bytes);
+    case ThresholdType::Below:
+      return detail::threshold_bytes<ThresholdType::Below>(in, n, threshold, bytes);
+    case ThresholdType::Both:
+    default:
+      return detail::threshold_bytes<ThresholdType::Both>(in, n, threshold, bytes);
+  }
+}
+
+}
@@ -3,6 +3,7 @@
 #include <xtensor/containers/xarray.hpp>
 #include <xtensor/views/xview.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -14,6 +15,10 @@ namespace puara_gestures::algorithms
 class VampModel
 {
 public:
+  using RowMajorMatrix
+      = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using RowMajorMap = Eigen::Map<const RowMajorMatrix>;
+
   VampModel(int lagtime, int n_dims)
       : m_lag(lagtime)
       , m_dims(n_dims)
@@ -23,47 +28,102 @@ public:
 
   void partial_fit(const xt::xarray<double>& data)
   {
-    if(data.shape()[0] <= m_lag)
+    partial_fit(data.data(), (Eigen::Index)data.shape()[0], (Eigen::Index)data.shape()[1]);
+  }
+
+  // One epoch of `rows` samples x `cols` features, row-major, read in place
+  void partial_fit(const double* data, Eigen::Index rows, Eigen::Index cols)
+  {
+    if(rows <= m_lag)
       return;
 
-    size_t n_features = data.shape()[1];
-    if(m_data_count == 0)
+    if(m_data_count == 0 || m_C00.rows() != cols)
     {
-      m_C00 = Eigen::MatrixXd::Zero(n_features, n_features);
-      m_C0t = Eigen::MatrixXd::Zero(n_features, n_features);
-      m_Ctt = Eigen::MatrixXd::Zero(n_features, n_features);
+      m_C00 = Eigen::MatrixXd::Zero(cols, cols);
+      m_C0t = Eigen::MatrixXd::Zero(cols, cols);
+      m_Ctt = Eigen::MatrixXd::Zero(cols, cols);
+      m_data_count = 0;
+    }
+    else if(m_forgetting < 1.0)
+    {
+      // Exponential forgetting: older epochs weigh less in the running sums
+      m_C00 *= m_forgetting;
+      m_C0t *= m_forgetting;
+      m_Ctt *= m_forgetting;
+      m_data_count *= m_forgetting;
     }
 
-    auto x_t = xt::view(data, xt::range(0, data.shape()[0] - m_lag), xt::all());
-    auto x_tau = xt::view(data, xt::range(m_lag, data.shape()[0]), xt::all());
+    // x_t is rows [0, rows - lag), x_tau is rows [lag, rows): both are
+    // contiguous in a row-major buffer
+    const Eigen::Index n = rows - m_lag;
+    RowMajorMap mat_t(data, n, cols);
+    RowMajorMap mat_tau(data + m_lag * cols, n, cols);
 
-    Eigen::Map<
-        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-        mat_t(x_t.data(), x_t.shape()[0], x_t.shape()[1]);
-    Eigen::Map<
-        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-        mat_tau(x_tau.data(), x_tau.shape()[0], x_tau.shape()[1]);
+    // Center the data (scratch matrices are reused from one epoch to the next)
+    m_mean_t = mat_t.colwise().mean();
+    m_mean_tau = mat_tau.colwise().mean();
 
-    // Center the data
-    Eigen::VectorXd mean_t = mat_t.colwise().mean();
-    Eigen::VectorXd mean_tau = mat_tau.colwise().mean();
+    m_centered_t = mat_t.rowwise() - m_mean_t;
+    m_centered_tau = mat_tau.rowwise() - m_mean_tau;
 
-    Eigen::MatrixXd centered_t = mat_t.rowwise() - mean_t.transpose();
-    Eigen::MatrixXd centered_tau = mat_tau.rowwise() - mean_tau.transpose();
+    m_C00.noalias() += m_centered_t.transpose() * m_centered_t;
+    m_C0t.noalias() += m_centered_t.transpose() * m_centered_tau;
+    m_Ctt.noalias() += m_centered_tau.transpose() * m_centered_tau;
+    m_data_count += n;
+  }
 
-    m_C00 += centered_t.transpose() * centered_t;
-    m_C0t += centered_t.transpose() * centered_tau;
-    m_Ctt += centered_tau.transpose() * centered_tau;
-    m_data_count += centered_t.rows();
+  // Running covariance sums: everything solve() needs, so that it can run
+  // on a copy away from the thread that accumulates epochs
+  struct Covariances
+  {
+    Eigen::MatrixXd C00;
+    Eigen::MatrixXd C0t;
+    Eigen::MatrixXd Ctt;
+    double count{0.0};
+    int lag{0};
+    int dims{0};
+  };
+
+  void covariances(Covariances& out) const
+  {
+    out.C00 = m_C00;
+    out.C0t = m_C0t;
+    out.Ctt = m_Ctt;
+    out.count = m_data_count;
+    out.lag = m_lag;
+    out.dims = m_dims;
   }
 
   bool solve()
   {
-    if(m_data_count < m_dims || m_data_count < m_lag * 2)
+    if(!solve(m_C00, m_C0t, m_Ctt, m_data_count, m_lag, m_dims, m_transform))
       return false;
-    Eigen::MatrixXd c00 = m_C00 / m_data_count;
-    Eigen::MatrixXd c0t = m_C0t / m_data_count;
-    Eigen::MatrixXd ctt = m_Ctt / m_data_count;
+    m_is_fitted = true;
+    return true;
+  }
+
+  static bool solve(const Covariances& cov, Eigen::MatrixXd& transform)
+  {
+    return solve(cov.C00, cov.C0t, cov.Ctt, cov.count, cov.lag, cov.dims, transform);
+  }
+
+  // Install a projection computed by the static solve()
+  void set_transform(Eigen::MatrixXd& transform)
+  {
+    m_transform.swap(transform);
+    m_is_fitted = true;
+  }
+
+  // Fills `transform` (features x components) only on success
+  static bool solve(
+      const Eigen::MatrixXd& C00, const Eigen::MatrixXd& C0t, const Eigen::MatrixXd& Ctt,
+      double count, int lag, int dims, Eigen::MatrixXd& transform)
+  {
+    if(count < dims || count < lag * 2)
+      return false;
+    Eigen::MatrixXd c00 = C00 / count;
+    Eigen::MatrixXd c0t = C0t / count;
+    Eigen::MatrixXd ctt = Ctt / count;
     double reg = 1e-6;
     c00 += reg * Eigen::MatrixXd::Identity(c00.rows(), c00.cols());
     ctt += reg * Eigen::MatrixXd::Identity(ctt.rows(), ctt.cols());
@@ -105,16 +165,15 @@ public:
       return a.first > b.first;
     });
 
-    // Take the top m_dims components
-    int num_components = std::min(m_dims, (int)eigen_pairs.size());
-    m_transform = Eigen::MatrixXd(eigenvecs.rows(), num_components);
+    // Take the top `dims` components
+    int num_components = std::min(dims, (int)eigen_pairs.size());
+    transform.resize(eigenvecs.rows(), num_components);
 
     for(int i = 0; i < num_components; ++i)
     {
-      m_transform.col(i) = eigenvecs.col(eigen_pairs[i].second);
+      transform.col(i) = eigenvecs.col(eigen_pairs[i].second);
     }
 
-    m_is_fitted = true;
     return true;
   }
 
@@ -123,21 +182,43 @@ public:
     if(!m_is_fitted || data.size() == 0)
       return xt::xarray<double>::from_shape({data.shape()[0], 0});
 
-    Eigen::Map<
-        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-        mat(data.data(), data.shape()[0], data.shape()[1]);
-
-    Eigen::MatrixXd transformed = mat * m_transform;
+    xt::xarray<double> result = xt::xarray<double>::from_shape(
+        {data.shape()[0], (size_t)m_transform.cols()});
+    transform(
+        data.data(), (Eigen::Index)data.shape()[0], (Eigen::Index)data.shape()[1],
+        result.data());
+    return result;
+  }
 
-    return xt::adapt(
-        transformed.data(), transformed.size(), xt::no_ownership(),
-        std::vector<size_t>{(size_t)transformed.rows(), (size_t)transformed.cols()});
+  // Project `rows` x `cols` row-major samples into `out`, row-major
+  // rows x components()
+  void transform(const double* data, Eigen::Index rows, Eigen::Index cols, double* out) const
+  {
+    RowMajorMap mat(data, rows, cols);
+    Eigen::Map<RowMajorMatrix> result(out, rows, m_transform.cols());
+    result.noalias() = mat * m_transform;
   }
 
+  // Number of columns written by transform()
+  int components() const { return (int)m_transform.cols(); }
+
+  // Number of input columns transform() expects: the channel count of the
+  // data the current projection was solved for
+  int features() const { return (int)m_transform.rows(); }
+
   bool is_fitted() const { return m_is_fitted; }
   int lag() const { return m_lag; }
   int dims() const { return m_dims; }
 
+  // The covariances do not depend on the number of output dimensions: a
+  // change only needs a new solve(), not a replay of the data.
+  void set_dims(int n_dims) { m_dims = n_dims; }
+
+  // Weight applied to the accumulated covariances before each new epoch
+  // (1 = plain running sums, < 1 = exponential forgetting)
+  void set_forgetting(double factor) { m_forgetting = std::clamp(factor, 0.0, 1.0); }
+  double forgetting() const { return m_forgetting; }
+
   void reset()
   {
     m_data_count = 0;
@@ -151,12 +232,18 @@ public:
 private:
   int m_lag;
   int m_dims;
-  long long m_data_count;
+  double m_data_count;
+  double m_forgetting{1.0};
   bool m_is_fitted{false};
 
   Eigen::MatrixXd m_C00;
   Eigen::MatrixXd m_C0t;
   Eigen::MatrixXd m_Ctt;
   Eigen::MatrixXd m_transform;
+
+  Eigen::RowVectorXd m_mean_t;
+  Eigen::RowVectorXd m_mean_tau;
+  RowMajorMatrix m_centered_t;
+  RowMajorMatrix m_centered_tau;
 };
 }
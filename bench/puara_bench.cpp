@@ -0,0 +1,797 @@
+// Micro-benchmark for the Puara objects.
+//
+// Every object is instantiated without a host, prepared like score would, then
+// ticked directly through operator() / operator()(tick) with synthetic sensor
+// streams. For each object and tick profile we report:
+//  - ns/tick:     mean wall-clock time of one operator() call (writing the
+//                 inputs is done outside of the timed region),
+//  - allocs/tick: heap allocations performed inside the timed loop,
+//  - peak RSS:    process-wide high-water mark after the case ran.
+//
+// Peak RSS is monotonic for the whole process; run a single object with the
+// filter argument (e.g. `puara_bench RateOfChange`) to get its own figure.
+
+#include "Puara/AvalanchesAvnd.hpp"
+#include "Puara/BioDataHeart.hpp"
+#include "Puara/BioDataSkinConductance.hpp"
+#include "Puara/Binarizer.hpp"
+#include "Puara/ButtonAvnd.hpp"
+#include "Puara/ClusteringAvnd.hpp"
+#include "Puara/CompassAvnd.hpp"
+#include "Puara/CorrelationAvnd.hpp"
+#include "Puara/ERPAvnd.hpp"
+#include "Puara/EdaRtFeatures.hpp"
+#include "Puara/GestureRecognizer.hpp"
+#include "Puara/GestureRecognizerMulti.hpp"
+#include "Puara/Jab.hpp"
+#include "Puara/Jab2D_Avnd.hpp"
+#include "Puara/Jab3D_Avnd.hpp"
+#include "Puara/MultiSmoother.hpp"
+#include "Puara/Normalization.hpp"
+#include "Puara/NormalizationAudio.hpp"
+#include "Puara/Orientation.hpp"
+#include "Puara/PCAAvnd.hpp"
+#include "Puara/PeakDetection.hpp"
+#include "Puara/PeakDetectionAudio.hpp"
+#include "Puara/PowerBandAvnd.hpp"
+#include "Puara/PowerBandEEGAvnd.hpp"
+#include "Puara/RateOfChange.hpp"
+#include "Puara/Roll.hpp"
+#include "Puara/Scaler.hpp"
+#include "Puara/ScalerAudio.hpp"
+#include "Puara/Shake.hpp"
+#include "Puara/Smoother.hpp"
+#include "Puara/ThresholdAvalanchesAvnd.hpp"
+#include "Puara/Tilt.hpp"
+#include "Puara/VAMPAvnd.hpp"
+#include "Puara/WalkerAvnd.hpp"
+#include "Puara/WelchPSDAvnd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numbers>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+//==============Allocation counting==================//
+// On glibc the malloc family is interposed, which also catches Eigen (it
+// allocates through std::malloc, not operator new). Elsewhere we fall back to
+// replacing the global operator new, which covers std containers and xtensor.
+namespace
+{
+std::atomic<std::uint64_t> g_allocations{0};
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+
+void* malloc(std::size_t n)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(n);
+}
+void* calloc(std::size_t n, std::size_t sz)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(n, sz);
+}
+void* realloc(void* p, std::size_t n)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(p, n);
+}
+void* aligned_alloc(std::size_t al, std::size_t n)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(al, n);
+}
+int posix_memalign(void** p, std::size_t al, std::size_t n)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  *p = __libc_memalign(al, n);
+  return *p ? 0 : ENOMEM;
+}
+}
+#else
+void* operator new(std::size_t n)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+void* operator new[](std::size_t n)
+{
+  return ::operator new(n);
+}
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+#endif
+
+namespace
+{
+using namespace puara_gestures::objects;
+using clk = std::chrono::steady_clock;
+
+//==============Tick profiles==================//
+// rate / frames gives the tick period seen by the objects, block is the length
+// of the arrays fed to the vector-port objects on each tick.
+struct Profile
+{
+  const char* name;
+  double rate;
+  int frames;
+  std::size_t block;
+};
+
+constexpr Profile profiles[] = {
+    {"100 Hz", 48000., 480, 64},
+    {"1 kHz", 48000., 48, 64},
+    {"audio", 48000., 512, 512},
+};
+
+// each case stops at whichever comes first
+constexpr int max_ticks = 20000;
+constexpr auto max_duration = std::chrono::milliseconds(500);
+constexpr int warmup_ticks = 64;
+
+std::string_view g_filter;
+
+bool selected(std::string_view name)
+{
+  return g_filter.empty() || name.find(g_filter) != std::string_view::npos;
+}
+
+// cost of the two clock reads around each tick, subtracted from ns/tick
+double g_timer_overhead_ns = 0.;
+
+//==============Synthetic sensor stream==================//
+// slow sine + uniform noise in [0, 1], deterministic across runs
+struct Stream
+{
+  double phase{0.};
+  double step{0.};
+  std::uint32_t state{0x9E3779B9u};
+
+  float noise()
+  {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) * (1.f / 16777216.f);
+  }
+
+  float next()
+  {
+    phase += step;
+    return static_cast<float>(0.5 + 0.4 * std::sin(phase)) + 0.1f * (noise() - 0.5f);
+  }
+
+  template <typename T>
+  void fill(std::vector<T>& v, std::size_t n)
+  {
+    v.resize(n);
+    for(auto& x : v)
+      x = next();
+  }
+
+  puara_gestures::Coord3D next3()
+  {
+    puara_gestures::Coord3D c;
+    c.x = next() * 2.f - 1.f;
+    c.y = noise() * 2.f - 1.f;
+    c.z = 1.f - next();
+    return c;
+  }
+};
+
+double peak_rss_mib()
+{
+#if defined(__APPLE__)
+  rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / (1024. * 1024.); // bytes
+#elif defined(__unix__)
+  rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024.; // KiB
+#else
+  return 0.;
+#endif
+}
+
+template <typename Obj>
+void tick(Obj& obj, const Profile& p, std::int64_t i)
+{
+  if constexpr(requires { typename Obj::tick; })
+  {
+    typename Obj::tick t{};
+    t.frames = p.frames;
+    if constexpr(requires { t.position_in_frames; })
+      t.position_in_frames = static_cast<decltype(t.position_in_frames)>(i * p.frames);
+    obj(t);
+  }
+  else
+  {
+    obj();
+  }
+}
+
+//==============Runner==================//
+// feed(obj, stream, profile, tick_index) writes the inputs for the next tick.
+template <typename Obj, typename Init = std::nullptr_t, typename Feed>
+void run(std::string_view name, Feed feed, Init init = nullptr)
+{
+  if(!selected(name))
+    return;
+
+  for(const Profile& p : profiles)
+  {
+    auto obj = std::make_unique<Obj>();
+    if constexpr(!std::is_same_v<Init, std::nullptr_t>)
+      init(*obj);
+
+    halp::setup s{};
+    s.rate = p.rate;
+    s.frames = p.frames;
+    if constexpr(requires { obj->prepare(s); })
+      obj->prepare(s);
+
+    Stream stream;
+    stream.step = 2. * std::numbers::pi * 1.3 * p.frames / p.rate;
+
+    std::int64_t i = 0;
+    for(; i < warmup_ticks; ++i)
+    {
+      feed(*obj, stream, p, i);
+      tick(*obj, p, i);
+    }
+
+    clk::duration elapsed{};
+    std::uint64_t allocs = 0;
+    int n = 0;
+    const auto deadline = clk::now() + max_duration;
+    for(; n < max_ticks && clk::now() < deadline; ++n, ++i)
+    {
+      feed(*obj, stream, p, i);
+
+      const auto a0 = g_allocations.load(std::memory_order_relaxed);
+      const auto t0 = clk::now();
+      tick(*obj, p, i);
+      const auto t1 = clk::now();
+      allocs += g_allocations.load(std::memory_order_relaxed) - a0;
+      elapsed += t1 - t0;
+    }
+
+    const double ns = std::max(
+        0., std::chrono::duration<double, std::nano>(elapsed).count() / std::max(n, 1)
+                - g_timer_overhead_ns);
+    std::printf(
+        "%-28.*s %-8s %8d %14.1f %12.2f %10.1f\n", int(name.size()), name.data(),
+        p.name, n, ns, double(allocs) / std::max(n, 1), peak_rss_mib());
+  }
+}
+
+//==============Shared feeders==================//
+// audio-rate objects read and write raw channel pointers
+struct AudioBuffers
+{
+  std::vector<double> in;
+  std::vector<double> out[4];
+
+  void fill(Stream& s, const Profile& p)
+  {
+    s.fill(in, std::size_t(p.frames));
+    for(auto& o : out)
+      o.resize(std::size_t(p.frames));
+  }
+};
+
+void feed_spectrum(
+    std::vector<double>& psd, std::vector<double>& freqs, Stream& s, const Profile& p)
+{
+  // one-sided spectrum of a `block`-point FFT at 256 Hz (EEG-like)
+  const std::size_t bins = p.block / 2 + 1;
+  if(freqs.size() != bins)
+  {
+    freqs.resize(bins);
+    for(std::size_t k = 0; k < bins; ++k)
+      freqs[k] = 256. * double(k) / double(p.block);
+  }
+  s.fill(psd, bins);
+}
+
+//==============Consistency checks==================//
+// Tilt and Roll reading an Orientation node must output exactly what they
+// compute from the same sensor stream on their own
+bool check_shared_orientation()
+{
+  Tilt tilt, shared_tilt;
+  Roll roll, shared_roll;
+  Orientation orientation;
+  shared_tilt.inputs.use_orientation = true;
+  shared_roll.inputs.use_orientation = true;
+
+  halp::setup setup{};
+  setup.rate = 100.;
+  setup.frames = 1;
+  tilt.prepare(setup);
+  shared_tilt.prepare(setup);
+  roll.prepare(setup);
+  shared_roll.prepare(setup);
+  orientation.prepare(setup);
+
+  Stream s;
+  s.step = 2. * std::numbers::pi * 1.3 / setup.rate;
+  halp::tick t{};
+  t.frames = 1;
+  double max_diff = 0.;
+  for(int i = 0; i < 2000; ++i)
+  {
+    const auto accel = s.next3();
+    const auto gyro = s.next3();
+    const auto mag = s.next3();
+    tilt.inputs.accel = roll.inputs.accel = orientation.inputs.accel = accel;
+    tilt.inputs.gyro = roll.inputs.gyro = orientation.inputs.gyro = gyro;
+    tilt.inputs.mag = roll.inputs.mag = orientation.inputs.mag = mag;
+    tilt(t);
+    roll(t);
+    orientation(t);
+
+    shared_tilt.inputs.orientation = orientation.outputs.orientation.value;
+    shared_roll.inputs.orientation = orientation.outputs.orientation.value;
+    shared_tilt(t);
+    shared_roll(t);
+
+    max_diff = std::max(
+        {max_diff, double(std::abs(tilt.outputs.output - shared_tilt.outputs.output)),
+         double(std::abs(roll.outputs.output - shared_roll.outputs.output))});
+  }
+
+  std::printf("%-28s max |own fusion - shared| = %g\n", "Orientation/check", max_diff);
+  return max_diff == 0.;
+}
+
+// OnlineKMeans must give every cluster its own center even when the first
+// ticks of the stream only come from one of them
+bool check_online_clusters()
+{
+  constexpr int n_features = 4;
+  constexpr int rows = 64;
+  constexpr double means[3] = {0., 10., -10.};
+
+  ClusteringAvnd o;
+  o.inputs.algorithm.value = ClusteringAvnd::Algorithm::OnlineKMeans;
+  o.inputs.n_features.value = n_features;
+  o.inputs.n_clusters.value = 3;
+  halp::setup setup{};
+  setup.rate = 100.;
+  setup.frames = 1;
+  o.prepare(setup);
+
+  std::mt19937 rng{42};
+  std::normal_distribution<double> noise{0., 0.5};
+  auto& matrix = o.inputs.matrix.value;
+  matrix.resize(rows * n_features);
+  for(int t = 0; t < 200; ++t)
+  {
+    for(int i = 0; i < rows; ++i)
+    {
+      const double mean = t < 20 ? means[0] : means[i % 3];
+      for(int c = 0; c < n_features; ++c)
+        matrix[i * n_features + c] = mean + noise(rng);
+    }
+    o();
+  }
+
+  // Distance from every true mean to its nearest center
+  const auto& centers = o.outputs.cluster_centers.value;
+  double max_dist = 0.;
+  for(double mean : means)
+  {
+    double best = std::numeric_limits<double>::max();
+    for(std::size_t j = 0; j + n_features <= centers.size(); j += n_features)
+    {
+      double dist = 0.;
+      for(int c = 0; c < n_features; ++c)
+        dist += (centers[j + c] - mean) * (centers[j + c] - mean);
+      best = std::min(best, std::sqrt(dist));
+    }
+    max_dist = std::max(max_dist, best);
+  }
+
+  std::printf(
+      "%-28s max |true mean - nearest center| = %g\n", "ClusteringAvnd/check", max_dist);
+  return centers.size() == 3 * n_features && max_dist < 1.;
+}
+}
+
+int main(int argc, char** argv)
+{
+  if(argc > 1)
+    g_filter = argv[1];
+
+  {
+    constexpr int n = 100000;
+    clk::duration total{};
+    for(int i = 0; i < n; ++i)
+    {
+      const auto t0 = clk::now();
+      total += clk::now() - t0;
+    }
+    g_timer_overhead_ns = std::chrono::duration<double, std::nano>(total).count() / n;
+  }
+
+  std::printf(
+      "%-28s %-8s %8s %14s %12s %10s\n", "object", "profile", "ticks", "ns/tick",
+      "allocs/tick", "RSS (MiB)");
+
+  // ---- scalar control-rate objects ---- //
+  run<Smoother>("Smoother", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.smooth_signal = s.next();
+  });
+  run<MultiSmoother>("MultiSmoother/64", [](auto& o, Stream& s, auto&, auto) {
+    s.fill(o.inputs.signals.value, 64);
+  });
+  run<Scaler>("Scaler/min-max", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.scaling_signal = s.next();
+  });
+  run<Scaler>(
+      "Scaler/quantile",
+      [](auto& o, Stream& s, auto&, auto) { o.inputs.scaling_signal = s.next(); },
+      [](Scaler& o) { o.inputs.mode.value = Scaler::Mode::Quantile; });
+  run<Normalization>("Normalization", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.normalization_signal = s.next();
+  });
+  run<PeakDetection>("PeakDetection", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.peakDetection_signal = s.next();
+  });
+  run<RateOfChange>("RateOfChange/samples", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.signal = s.next();
+  });
+  run<RateOfChange>(
+      "RateOfChange/time",
+      [](auto& o, Stream& s, auto&, auto) { o.inputs.signal = s.next(); },
+      [](RateOfChange& o) {
+        o.inputs.window_mode.value = RateOfChange::WindowMode::TimeWindow;
+      });
+  run<EdaRtFeatures>("EdaRtFeatures", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.signal = 2.f + s.next();
+  });
+  run<BioData_Heart>("BioData_Heart", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.heart_signal = s.next();
+  });
+  run<BioData_Skin_Conductance>(
+      "BioData_Skin_Conductance",
+      [](auto& o, Stream& s, auto&, auto) { o.inputs.sc_signal = s.next(); });
+  run<ButtonAvnd>("ButtonAvnd", [](auto& o, Stream&, auto&, std::int64_t i) {
+    o.inputs.button_input = int((i / 7) % 2);
+  });
+  run<WalkerAvnd>("WalkerAvnd", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.angle = 360. * s.next();
+    o.inputs.velocity = 0.01 * s.next();
+  });
+
+  // ---- audio-rate objects ---- //
+  AudioBuffers audio;
+  run<ScalerAudio>("ScalerAudio", [&](auto& o, Stream& s, const Profile& p, auto) {
+    audio.fill(s, p);
+    o.inputs.audio.channel = audio.in.data();
+    o.outputs.audio.channel = audio.out[0].data();
+  });
+  run<NormalizationAudio>(
+      "NormalizationAudio", [&](auto& o, Stream& s, const Profile& p, auto) {
+        audio.fill(s, p);
+        o.inputs.audio.channel = audio.in.data();
+        o.outputs.audio.channel = audio.out[0].data();
+      });
+  run<PeakDetectionAudio>(
+      "PeakDetectionAudio", [&](auto& o, Stream& s, const Profile& p, auto) {
+        audio.fill(s, p);
+        o.inputs.audio.channel = audio.in.data();
+        o.outputs.peak_max.channel = audio.out[0].data();
+        o.outputs.peak_min.channel = audio.out[1].data();
+        o.outputs.peak_rising.channel = audio.out[2].data();
+        o.outputs.peak_falling.channel = audio.out[3].data();
+      });
+  run<WelchPSDAvnd>("WelchPSDAvnd", [&](auto& o, Stream& s, const Profile& p, auto) {
+    audio.fill(s, p);
+    o.inputs.audio.channel = audio.in.data();
+  });
+
+  // ---- IMU objects ---- //
+  run<Jab1D_Avnd>("Jab1D_Avnd", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.acceleration_1d = 10.f * s.next();
+  });
+  run<Jab2D_Avnd>("Jab2D_Avnd", [](auto& o, Stream& s, auto&, auto) {
+    auto c = s.next3();
+    o.inputs.acceleration_2d.value.x = 10. * c.x;
+    o.inputs.acceleration_2d.value.y = 10. * c.y;
+  });
+  run<Jab3D_Avnd>("Jab3D_Avnd", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel_3D = s.next3();
+  });
+  run<Shake>("Shake", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel = s.next3();
+  });
+  run<Tilt>("Tilt", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel = s.next3();
+    o.inputs.gyro = s.next3();
+    o.inputs.mag = s.next3();
+  });
+  run<Roll>("Roll", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel = s.next3();
+    o.inputs.gyro = s.next3();
+    o.inputs.mag = s.next3();
+  });
+  run<Orientation>("Orientation", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel = s.next3();
+    o.inputs.gyro = s.next3();
+    o.inputs.mag = s.next3();
+  });
+  run<Roll>("Roll/shared", [](auto& o, Stream& s, auto&, auto) {
+    const auto [x, y, z] = s.next3();
+    o.inputs.use_orientation = true;
+    o.inputs.orientation.value = {1.0, 0.0, 0.0, 0.0, x, y, z};
+  });
+  run<GestureRecognizer>("GestureRecognizer", [](auto& o, Stream& s, auto&, auto) {
+    o.inputs.accel = s.next3();
+    o.inputs.gyro = s.next3();
+    o.inputs.mag = s.next3();
+    o.inputs.heart_signal = s.next();
+    o.inputs.GSR_signal = s.next();
+  });
+  run<GestureRecognizer>(
+      "GestureRecognizer/jab-shake", [](auto& o, Stream& s, auto&, auto) {
+        o.inputs.enable_tilt = false;
+        o.inputs.enable_roll = false;
+        o.inputs.enable_heart = false;
+        o.inputs.enable_gsr = false;
+        o.inputs.accel = s.next3();
+      });
+  run<GestureRecognizerMulti>(
+      "GestureRecognizerMulti/20", [](auto& o, Stream& s, auto&, auto) {
+        // 20 performers
+        auto& in = o.inputs;
+        for(auto* v : {&in.accel.value, &in.gyro.value, &in.mag.value})
+        {
+          v->resize(20);
+          for(auto& c : *v)
+            c = s.next3();
+        }
+        s.fill(in.heart_signal.value, 20);
+        s.fill(in.GSR_signal.value, 20);
+      });
+
+  // ---- vector-port objects ---- //
+  run<CorrelationAvnd>("CorrelationAvnd", [](auto& o, Stream& s, const Profile& p, auto) {
+    s.fill(o.inputs.data1.value, p.block);
+    s.fill(o.inputs.data2.value, p.block);
+  });
+  run<CorrelationAvnd>(
+      "CorrelationAvnd/streaming",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data1.value, p.block);
+        s.fill(o.inputs.data2.value, p.block);
+      },
+      [](CorrelationAvnd& o) {
+        o.inputs.mode.value = CorrelationAvnd::Mode::Streaming;
+        o.inputs.window.value = 4096;
+      });
+  run<PowerBandAvnd>("PowerBandAvnd", [](auto& o, Stream& s, const Profile& p, auto) {
+    feed_spectrum(o.inputs.psd.value, o.inputs.frequencies.value, s, p);
+  });
+  run<PowerBandEEGAvnd>(
+      "PowerBandEEGAvnd", [](auto& o, Stream& s, const Profile& p, auto) {
+        feed_spectrum(o.inputs.psd.value, o.inputs.frequencies.value, s, p);
+      });
+  run<ERPAvnd>("ERPAvnd", [](auto& o, Stream& s, const Profile& p, std::int64_t i) {
+    s.fill(o.inputs.signal.value, p.block);
+    if(i % 50 == 0)
+      o.inputs.trigger.value = true;
+    else
+      o.inputs.trigger.value.reset();
+  });
+  run<ERPAvnd>(
+      "ERPAvnd/multichannel",
+      [](auto& o, Stream& s, const Profile& p, std::int64_t i) {
+        s.fill(o.inputs.signal.value, p.block);
+        if(i % 10 == 0)
+          o.inputs.trigger.value = true;
+        else
+          o.inputs.trigger.value.reset();
+      },
+      [](ERPAvnd& o) {
+        // 32 interleaved channels, an epoch every 10 ticks
+        o.inputs.channels.value = 32;
+        o.inputs.duration.value = 0.01f;
+        o.inputs.overlap.value = true;
+      });
+  run<AvalanchesAvnd>(
+      "AvalanchesAvnd", [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.input_array.value, p.block);
+        for(auto& x : o.inputs.input_array.value)
+          x = x > 0.9 ? 1. : 0.;
+      });
+  run<AvalanchesAvnd>(
+      "AvalanchesAvnd/streaming",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.input_array.value, p.block);
+        for(auto& x : o.inputs.input_array.value)
+          x = x > 0.9 ? 1. : 0.;
+      },
+      [](AvalanchesAvnd& o) { o.inputs.streaming.value = true; });
+  run<ThresholdAvalanchesAvnd>(
+      "ThresholdAvalanchesAvnd",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.input_array.value, p.block);
+        for(auto& x : o.inputs.input_array.value)
+          x = 4. * (x - 0.5);
+      },
+      [](ThresholdAvalanchesAvnd& o) {
+        o.inputs.channels.value = 8;
+        o.inputs.threshold.value = 1.9f;
+        o.inputs.streaming.value = true;
+      });
+  run<Binarizer>("Binarizer", [](auto& o, Stream& s, const Profile& p, auto) {
+    s.fill(o.inputs.input_array.value, p.block);
+    for(auto& x : o.inputs.input_array.value)
+      x = 4. * (x - 0.5);
+  });
+  run<Binarizer>(
+      "Binarizer/bits",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.input_array.value, p.block);
+        for(auto& x : o.inputs.input_array.value)
+          x = 4. * (x - 0.5);
+      },
+      [](Binarizer& o) { o.inputs.output_format.value = Binarizer::OutputFormat::Bits; });
+  run<Binarizer>(
+      "Binarizer/float-bits",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.input_float.value, p.block);
+        for(auto& x : o.inputs.input_float.value)
+          x = 4.f * (x - 0.5f);
+      },
+      [](Binarizer& o) { o.inputs.output_format.value = Binarizer::OutputFormat::Bits; });
+  run<CompassAvnd>("CompassAvnd", [](auto& o, Stream& s, const Profile& p, auto) {
+    s.fill(o.inputs.pole1.value, p.block);
+    s.fill(o.inputs.pole2.value, p.block);
+  });
+  run<CompassAvnd>(
+      "CompassAvnd/fast",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.pole1.value, p.block);
+        s.fill(o.inputs.pole2.value, p.block);
+      },
+      [](CompassAvnd& o) { o.inputs.accuracy.value = CompassAvnd::Accuracy::Fast; });
+  run<ClusteringAvnd>(
+      "ClusteringAvnd/kmeans",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.matrix.value, p.block);
+      },
+      [](ClusteringAvnd& o) {
+        o.inputs.n_features.value = 4;
+        o.inputs.n_clusters.value = 3;
+      });
+  run<ClusteringAvnd>(
+      "ClusteringAvnd/agglomerative",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.matrix.value, p.block);
+      },
+      [](ClusteringAvnd& o) {
+        o.inputs.algorithm.value = ClusteringAvnd::Algorithm::Agglomerative;
+        o.inputs.n_features.value = 4;
+        o.inputs.n_clusters.value = 3;
+      });
+  run<ClusteringAvnd>(
+      "ClusteringAvnd/online",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.matrix.value, p.block);
+      },
+      [](ClusteringAvnd& o) {
+        o.inputs.algorithm.value = ClusteringAvnd::Algorithm::OnlineKMeans;
+        o.inputs.n_features.value = 4;
+        o.inputs.n_clusters.value = 3;
+      });
+  run<ClusteringAvnd>(
+      "ClusteringAvnd/background",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.matrix.value, p.block);
+      },
+      [](ClusteringAvnd& o) {
+        o.inputs.n_features.value = 4;
+        o.inputs.n_clusters.value = 3;
+        o.inputs.background.value = true;
+      });
+  run<PCAAvnd>(
+      "PCAAvnd",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data.value, p.block);
+      },
+      [](PCAAvnd& o) {
+        o.inputs.n_features.value = 4;
+        o.inputs.n_components.value = 2;
+      });
+  run<PCAAvnd>(
+      "PCAAvnd/streaming",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data.value, p.block);
+      },
+      [](PCAAvnd& o) {
+        o.inputs.n_features.value = 4;
+        o.inputs.n_components.value = 2;
+        o.inputs.mode.value = PCAAvnd::Mode::Streaming;
+      });
+  run<PCAAvnd>(
+      "PCAAvnd/topk",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data.value, p.block);
+      },
+      [](PCAAvnd& o) {
+        o.inputs.n_features.value = 32;
+        o.inputs.n_components.value = 4;
+        o.inputs.mode.value = PCAAvnd::Mode::Streaming;
+        o.inputs.solve_every.value = 1;
+        o.inputs.solver.value = PCAAvnd::Solver::TopK;
+      });
+  run<PCAAvnd>(
+      "PCAAvnd/background",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data.value, p.block);
+      },
+      [](PCAAvnd& o) {
+        o.inputs.n_features.value = 4;
+        o.inputs.n_components.value = 2;
+        o.inputs.background.value = true;
+      });
+  run<VAMPAvnd>(
+      "VAMPAvnd",
+      [](auto& o, Stream& s, const Profile& p, auto) {
+        s.fill(o.inputs.data.value, p.block);
+      },
+      [](VAMPAvnd& o) { o.inputs.n_channels.value = 2; });
+
+  if(selected("Orientation/check") && !check_shared_orientation())
+  {
+    std::fprintf(stderr, "Tilt / Roll differ between own and shared fusion\n");
+    return 1;
+  }
+  if(selected("ClusteringAvnd/check") && !check_online_clusters())
+  {
+    std::fprintf(stderr, "OnlineKMeans did not find one center per cluster\n");
+    return 1;
+  }
+  return 0;
+}